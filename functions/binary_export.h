@@ -0,0 +1,391 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_BINARY_EXPORT_H
+#define DSP_SIMULATION_BINARY_EXPORT_H
+
+#include <span>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "signal_writer.hh"
+#include "../types/signal_t.hpp"
+
+namespace mechdancer {
+    static_assert(std::endian::native == std::endian::little, "binary export assumes a little-endian host");
+    
+    /// 二进制导出格式
+    enum class binary_format {
+        npz, // numpy 的 .npz，用 numpy.load 读取
+        mat, // MAT v5，用 MATLAB/Octave 的 load 或 scipy.io.loadmat 读取
+    };
+    
+    /// 导出时的采样值：float、double 及其复数原样保存，整数原样保存，
+    /// long double、定点数转为 double，非浮点的复数转为 complex_t<double>
+    template<class t>
+    auto export_value(t const &x) {
+        if constexpr (requires { x.re; x.im; }) {
+            using u = std::remove_cvref_t<decltype(x.re)>;
+            if constexpr (std::is_same_v<u, float> || std::is_same_v<u, double>)
+                return x;
+            else
+                return complex_t<double>(static_cast<double>(x.re), static_cast<double>(x.im));
+        } else if constexpr (std::is_integral_v<t> || std::is_same_v<t, float> || std::is_same_v<t, double>)
+            return x;
+        else
+            return static_cast<double>(x);
+    }
+    
+    template<class t>
+    using export_t = decltype(export_value(std::declval<t>()));
+    
+    /// 信号转为导出用的采样值，右值信号的存储类型相同时直接移交
+    /// \tparam t 信号类型
+    /// \param signal 信号
+    /// \return 采样值
+    template<class t> requires Signal<std::remove_cvref_t<t>>
+    auto export_values(t &&signal) {
+        using signal_type = std::remove_cvref_t<t>;
+        using value_t = typename signal_type::value_t;
+        std::vector<export_t<value_t>> values;
+        if constexpr (!std::is_lvalue_reference_v<t> && requires { requires std::is_same_v<typename signal_type::container_t, std::vector<export_t<value_t>>>; })
+            values = std::move(signal.values);
+        else {
+            values.reserve(signal.values.size());
+            for (auto const &x : signal.values) values.push_back(export_value(x));
+        }
+        return values;
+    }
+    
+    /// 导出的信号：采样值及以 Hz、秒为单位的元数据
+    template<class t>
+    struct exported_signal_t {
+        std::vector<t> values;
+        double sampling_frequency, begin_time;
+    };
+    
+    /// 信号转为导出的信号
+    template<class t> requires Signal<std::remove_cvref_t<t>>
+    auto exported_signal(t &&signal) {
+        using namespace std::chrono;
+        auto fs = signal.sampling_frequency.template cast_to<Hz_t>().value;
+        auto begin = duration_cast<duration<double>>(signal.begin_time).count();
+        auto values = export_values(std::forward<t>(signal));
+        return exported_signal_t<typename decltype(values)::value_type>{
+            .values = std::move(values),
+            .sampling_frequency = static_cast<double>(fs),
+            .begin_time = begin,
+        };
+    }
+    
+    // region npz
+    
+    /// numpy 的类型描述，如 <f4、<c8、|u1
+    template<class t>
+    std::string npy_descr() {
+        if constexpr (requires(t x) { x.re; x.im; })
+            return "<c" + std::to_string(sizeof(t));
+        else if constexpr (std::is_same_v<t, bool>)
+            return "|b1";
+        else {
+            auto kind = std::is_floating_point_v<t> ? 'f' : std::is_signed_v<t> ? 'i' : 'u';
+            return (sizeof(t) == 1 ? "|" : "<") + std::string(1, kind) + std::to_string(sizeof(t));
+        }
+    }
+    
+    /// .npy 1.0 文件头，连同魔数的总长度按 64 字节对齐
+    /// \tparam t 元素类型
+    /// \param shape 形状，一维数组为 "(n,)"，标量为 "()"
+    template<class t>
+    std::string npy_header(std::string const &shape) {
+        auto dict = "{'descr': '" + npy_descr<t>() + "', 'fortran_order': False, 'shape': " + shape + ", }";
+        auto length = (dict.size() + 1 + 10 + 63) / 64 * 64 - 10;
+        dict.resize(length - 1, ' ');
+        dict += '\n';
+        std::string result("\x93NUMPY\x01\x00", 8);
+        result += static_cast<char>(length & 0xff);
+        result += static_cast<char>(length >> 8);
+        return result + dict;
+    }
+    
+    /// 增量计算 CRC-32（zip 使用的多项式）
+    /// \param crc 之前的结果，初值为 0
+    /// \param data 数据
+    /// \param size 字节数
+    /// \return 新的结果
+    inline uint32_t crc32(uint32_t crc, void const *data, size_t size) {
+        constexpr static auto TABLE = [] {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                auto c = i;
+                for (auto k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                table[i] = c;
+            }
+            return table;
+        }();
+        auto p = static_cast<uint8_t const *>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) crc = TABLE[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+    
+    /// 不压缩的 zip 归档，每个成员是一个 .npy 数组
+    class npz_writer_t {
+        struct entry_t {
+            std::string name;
+            uint32_t crc, size, offset;
+        };
+        
+        text_writer_t &_file;
+        std::vector<entry_t> _entries;
+        uint64_t _offset = 0;
+        
+        template<class t>
+        void put(t value) {
+            char bytes[sizeof(t)];
+            for (size_t i = 0; i < sizeof(t); ++i) bytes[i] = static_cast<char>(value >> (8 * i));
+            write(bytes, sizeof bytes);
+        }
+        
+        void write(void const *data, size_t size) {
+            _file.write(data, size);
+            _offset += size;
+        }
+        
+        /// 本地文件头与中央目录项的公共部分：版本、标志、方法（存储）、时间、日期（1980-01-01）
+        void put_common(entry_t const &entry) {
+            put<uint16_t>(20);
+            put<uint16_t>(0);
+            put<uint16_t>(0);
+            put<uint16_t>(0);
+            put<uint16_t>(0x21);
+            put<uint32_t>(entry.crc);
+            put<uint32_t>(entry.size);
+            put<uint32_t>(entry.size);
+            put<uint16_t>(static_cast<uint16_t>(entry.name.size()));
+            put<uint16_t>(0);
+        }
+    
+    public:
+        explicit npz_writer_t(text_writer_t &file) : _file(file) {}
+        
+        npz_writer_t(npz_writer_t const &) = delete;
+        
+        npz_writer_t &operator=(npz_writer_t const &) = delete;
+        
+        /// 写入一个数组，名为 name.npy
+        /// \param name 数组名
+        /// \param values 采样值
+        /// \param shape 形状，默认为一维
+        template<class t>
+        void add(std::string const &name, std::span<t const> values, std::string shape = {}) {
+            if (shape.empty()) shape = "(" + std::to_string(values.size()) + ",)";
+            auto header = npy_header<t>(shape);
+            const auto bytes = header.size() + values.size_bytes();
+            if (bytes >= 0xffffffffu || _offset >= 0xffffffffu)
+                throw std::length_error("npz archive larger than 4 GiB is not supported");
+            entry_t entry{
+                .name = name + ".npy",
+                .crc = crc32(crc32(0, header.data(), header.size()), values.data(), values.size_bytes()),
+                .size = static_cast<uint32_t>(bytes),
+                .offset = static_cast<uint32_t>(_offset),
+            };
+            put<uint32_t>(0x04034b50);
+            put_common(entry);
+            write(entry.name.data(), entry.name.size());
+            write(header.data(), header.size());
+            write(values.data(), values.size_bytes());
+            _entries.push_back(std::move(entry));
+        }
+        
+        /// 写入一个标量
+        template<class t>
+        void add(std::string const &name, t value) {
+            add(name, std::span<t const>(&value, 1), "()");
+        }
+        
+        /// 写出中央目录，结束归档
+        void finish() {
+            const auto begin = _offset;
+            for (auto const &entry : _entries) {
+                put<uint32_t>(0x02014b50);
+                put<uint16_t>(20);
+                put_common(entry);
+                put<uint16_t>(0);
+                put<uint16_t>(0);
+                put<uint16_t>(0);
+                put<uint32_t>(0);
+                put<uint32_t>(entry.offset);
+                write(entry.name.data(), entry.name.size());
+            }
+            const auto size = _offset - begin;
+            if (_offset >= 0xffffffffu)
+                throw std::length_error("npz archive larger than 4 GiB is not supported");
+            put<uint32_t>(0x06054b50);
+            put<uint16_t>(0);
+            put<uint16_t>(0);
+            put<uint16_t>(static_cast<uint16_t>(_entries.size()));
+            put<uint16_t>(static_cast<uint16_t>(_entries.size()));
+            put<uint32_t>(static_cast<uint32_t>(size));
+            put<uint32_t>(static_cast<uint32_t>(begin));
+            put<uint16_t>(0);
+        }
+    };
+    
+    /// 信号写为 .npz，包含 values、sampling_frequency（Hz）、begin_time（秒）三个数组
+    template<class t>
+    void write_npz(text_writer_t &file, exported_signal_t<t> const &signal) {
+        npz_writer_t npz(file);
+        npz.add("values", std::span<t const>(signal.values));
+        npz.add("sampling_frequency", signal.sampling_frequency);
+        npz.add("begin_time", signal.begin_time);
+        npz.finish();
+    }
+    
+    // endregion
+    // region MAT v5
+    
+    /// 复数的实部、虚部类型，实数不变
+    template<class t>
+    struct mat_part { using type = t; };
+    
+    template<class t>
+    struct mat_part<complex_t<t>> { using type = t; };
+    
+    /// MAT v5 的数组类型（mxClass）和数据类型（miType）
+    template<class t>
+    constexpr std::pair<uint32_t, uint32_t> mat_types() {
+        if constexpr (std::is_same_v<t, double>) return {6, 9};
+        else if constexpr (std::is_same_v<t, float>) return {7, 7};
+        else if constexpr (std::is_same_v<t, bool>) return {9, 2};
+        else {
+            static_assert(std::is_integral_v<t>, "unsupported element type");
+            constexpr uint32_t index = std::bit_width(sizeof(t)) - 1; // 1, 2, 4, 8 字节 -> 0, 1, 2, 3
+            constexpr uint32_t mi_signed[]{1, 3, 5, 12};
+            constexpr uint32_t mi_unsigned[]{2, 4, 6, 13};
+            if constexpr (std::is_signed_v<t>) return {8 + 2 * index, mi_signed[index]};
+            else return {9 + 2 * index, mi_unsigned[index]};
+        }
+    }
+    
+    /// MAT v5 文件输出，每个变量是一个列向量或标量
+    class mat_writer_t {
+        constexpr static uint32_t MI_INT8 = 1, MI_INT32 = 5, MI_UINT32 = 6, MI_MATRIX = 14;
+        constexpr static uint32_t LOGICAL = 0x0200, COMPLEX = 0x0800;
+        
+        text_writer_t &_file;
+        
+        static uint64_t padded(uint64_t size) { return (size + 7) / 8 * 8; }
+        
+        void tag(uint32_t type, uint64_t size) {
+            if (size > 0xffffffffu) throw std::length_error("MAT v5 variable larger than 4 GiB is not supported");
+            uint32_t words[]{type, static_cast<uint32_t>(size)};
+            _file.write(words, sizeof words);
+        }
+        
+        /// 数据元素：标签、数据，补齐到 8 字节
+        void element(uint32_t type, void const *data, uint64_t size) {
+            constexpr static char ZEROS[8]{};
+            tag(type, size);
+            _file.write(data, size);
+            _file.write(ZEROS, padded(size) - size);
+        }
+    
+    public:
+        /// 写出 128 字节的文件头
+        explicit mat_writer_t(text_writer_t &file) : _file(file) {
+            std::string text = "MATLAB 5.0 MAT-file, Platform: dsp-simulation";
+            text.resize(116, ' ');
+            text.append(8, '\0');             // 子系统数据偏移
+            text += std::string("\x00\x01", 2); // 版本 0x0100
+            text += "IM";                      // 小端
+            _file << std::string_view(text);
+        }
+        
+        mat_writer_t(mat_writer_t const &) = delete;
+        
+        mat_writer_t &operator=(mat_writer_t const &) = delete;
+        
+        /// 写入一个变量，复数分实部、虚部两段保存
+        /// \param name 变量名
+        /// \param values 采样值
+        template<class t>
+        void add(std::string const &name, std::span<t const> values) {
+            constexpr static auto is_complex = requires(t x) { x.re; x.im; };
+            using part_t = typename mat_part<t>::type;
+            const auto [mx_class, mi_type] = mat_types<part_t>();
+            const auto part_bytes = values.size() * sizeof(part_t);
+            
+            const auto size = 16 + 16 + 8 + padded(name.size()) + (is_complex ? 2 : 1) * (8 + padded(part_bytes));
+            tag(MI_MATRIX, size);
+            const uint32_t flags[]{mx_class | (is_complex ? COMPLEX : 0) | (std::is_same_v<part_t, bool> ? LOGICAL : 0), 0};
+            element(MI_UINT32, flags, sizeof flags);
+            const int32_t dims[]{static_cast<int32_t>(values.size()), 1};
+            element(MI_INT32, dims, sizeof dims);
+            element(MI_INT8, name.data(), name.size());
+            if constexpr (is_complex) {
+                std::vector<part_t> part(values.size());
+                for (size_t i = 0; i < values.size(); ++i) part[i] = values[i].re;
+                element(mi_type, part.data(), part_bytes);
+                for (size_t i = 0; i < values.size(); ++i) part[i] = values[i].im;
+                element(mi_type, part.data(), part_bytes);
+            } else
+                element(mi_type, values.data(), part_bytes);
+        }
+        
+        /// 写入一个标量
+        template<class t>
+        void add(std::string const &name, t value) {
+            add(name, std::span<t const>(&value, 1));
+        }
+    };
+    
+    /// 信号写为 MAT v5，包含 values、sampling_frequency（Hz）、begin_time（秒）三个变量，
+    /// 在 MATLAB 中 x = load(...) 得到以三者为字段的结构体
+    template<class t>
+    void write_mat(text_writer_t &file, exported_signal_t<t> const &signal) {
+        mat_writer_t mat(file);
+        mat.add("values", std::span<t const>(signal.values));
+        mat.add("sampling_frequency", signal.sampling_frequency);
+        mat.add("begin_time", signal.begin_time);
+    }
+    
+    // endregion
+    
+    /// 以二进制格式写出导出的信号
+    /// \param file 输出
+    /// \param signal 导出的信号
+    /// \param format 格式
+    template<class t>
+    void write_binary(text_writer_t &file, exported_signal_t<t> const &signal, binary_format format) {
+        switch (format) {
+            case binary_format::npz:
+                write_npz(file, signal);
+                break;
+            case binary_format::mat:
+                write_mat(file, signal);
+                break;
+        }
+    }
+    
+    /// 同步地以二进制格式保存信号，写入失败时抛出 std::runtime_error
+    /// \tparam t 信号类型
+    /// \param path 文件路径
+    /// \param signal 信号
+    /// \param format 格式
+    template<class t> requires Signal<std::remove_cvref_t<t>>
+    void save_binary(std::string const &path, t &&signal, binary_format format) {
+        text_writer_t file(path);
+        write_binary(file, exported_signal(std::forward<t>(signal)), format);
+        file.close();
+    }
+}
+
+#endif // DSP_SIMULATION_BINARY_EXPORT_H
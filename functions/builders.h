@@ -10,27 +10,29 @@
 #include <functional>
 
 #include "../types/signal_t.hpp"
+#include "text_loader.h"
+#include "signal_writer.hh"
 
 namespace mechdancer {
-    /// źŲ
-    /// \tparam value_t ֵ
-    /// \param f0 ʼƵ
-    /// \param k Ƶ
-    /// \param t ʱ
-    /// \return ֵ
+    /// 从啁啾信号采样
+    /// \tparam value_t 采样值类型
+    /// \param f0 起始频率
+    /// \param k 变频率
+    /// \param t 时间
+    /// \return 采样值
     template<Number value_t>
     static value_t sample_chirp(float f0, float k, floating_seconds t) {
         return static_cast<value_t>(std::sin(2 * PI * (f0 + k * t.count()) * t.count()));
     }
     
-    /// ౹캯
-    /// \tparam value_t ֵ
-    /// \tparam f_t Ƶ
-    /// \tparam t_t ʱ
-    /// \param f0 ʼƵ
-    /// \param f1 ֹƵ
-    /// \param time ʱ
-    /// \return ౲
+    /// 构造啁啾构造函数
+    /// \tparam value_t 值类型
+    /// \tparam f_t 频率类型
+    /// \tparam t_t 时间类型
+    /// \param f0 起始频率
+    /// \param f1 终止频率
+    /// \param time 时间
+    /// \return 啁啾采样海曙
     template<Number value_t = float, Frequency f_t, Time t_t>
     auto chirp(f_t f0, f_t f1, t_t time) {
         using namespace std::placeholders;
@@ -48,16 +50,16 @@ namespace mechdancer {
         return [fs](auto t) { return static_cast<value_t>(std::sin(2 * PI * fs.template cast_to<Hz_t>().value * floating_seconds(t).count())); };
     }
     
-    /// źŲ
-    /// \tparam size 
-    /// \tparam value_t 
-    /// \tparam frequency_t Ƶ
-    /// \tparam time_t ʱ
-    /// \tparam origin_t ź
-    /// \param origin ź
-    /// \param fs Ƶ
-    /// \param t0 ʼʱ
-    /// \return ɢź
+    /// 从连续信号采样
+    /// \tparam size 长度
+    /// \tparam value_t 数据类型
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    /// \tparam origin_t 连续信号类型
+    /// \param origin 连续信号
+    /// \param fs 采样频率
+    /// \param t0 起始时间
+    /// \return 离散信号
     template<class value_t = float, Frequency frequency_t, Time time_t, class origin_t>
     auto sample(size_t size, origin_t origin, frequency_t fs, time_t t0 = time_t::zero) {
         auto result = signal_of<value_t>(size, fs, t0);
@@ -67,37 +69,42 @@ namespace mechdancer {
         return result;
     }
     
-    /// ָ ASCII ļʱź
-    /// \tparam value_t 
-    /// \tparam frequency_t Ƶ
-    /// \tparam time_t ʱ
-    /// \param file_name ļ
-    /// \param fs Ƶ
-    /// \param t0 ʼʱ
-    /// \return ɢź
+    /// 按基本分隔符从 ASCII 文件加载时域信号
+    /// 映射文件后分块并行解析，并在文件旁写出二进制缓存，文件不变时下次直接读入缓存
+    /// \tparam value_t 数据类型
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    /// \param file_name 文件名
+    /// \param fs 采样频率
+    /// \param t0 起始时间
+    /// \return 离散信号
     template<class value_t = float, Frequency frequency_t, Time time_t>
     auto load(std::string const &file_name, frequency_t fs, time_t t0 = time_t::zero) {
-        auto file = std::ifstream(file_name);
         auto result = signal_of(0, fs, t0);
-        value_t value;
-        while (file >> value) result.values.push_back(value);
+        result.values = load_numbers<value_t, typename decltype(result)::value_t>(file_name);
         return result;
     }
     
-    /// źŵļ
-    /// \tparam _signal_t ź
-    /// \param file_name ļ·
-    /// \param signal ź
-    /// \param formatter ʽ
+    /// 保存信号到文件，写入失败时抛出 std::runtime_error
+    /// \tparam _signal_t 信号类型
+    /// \param file_name 文件名（包括路径）
+    /// \param signal 信号
+    /// \param formatter 输出格式编码器
     template<Signal _signal_t, class sava_formatter_t>
     void save(std::string const &file_name, _signal_t const &signal, sava_formatter_t const &formatter) {
-        for (std::ofstream file(file_name); auto x : signal.values) formatter(file, x);
+        text_writer_t file(file_name);
+        for (auto x : signal.values) formatter(file, x);
+        file.close();
     }
     
-    #define SAVE_SIGNAL_FORMAT(PATH, S, TF) save(PATH, S, [](std::ofstream &file, typename decltype(S)::value_t x) { file << TF; })
-    #define SAVE_SIGNAL_TF(PATH, S, TF) SAVE_SIGNAL_FORMAT(PATH, S, (TF) << std::endl)
+    #define SIGNAL_FORMATTER(S, TF) [](auto &file, typename std::remove_cvref_t<decltype(S)>::value_t x) { file << TF; }
+    #define SAVE_SIGNAL_FORMAT(PATH, S, TF) save(PATH, S, SIGNAL_FORMATTER(S, TF))
+    #define SAVE_SIGNAL_TF(PATH, S, TF) SAVE_SIGNAL_FORMAT(PATH, S, (TF) << '\n')
     #define SAVE_SIGNAL(PATH, S) SAVE_SIGNAL_TF(PATH, S, x)
-    #define SAVE_SIGNAL_AUTO(SB, S) SAVE_SIGNAL(SB.save(#S), S)
+    // 以下经 script_builder_t 在后台写出
+    #define SAVE_SIGNAL_ASYNC(SB, PATH, S) SB.save(PATH, S, SIGNAL_FORMATTER(S, (x) << '\n'))
+    #define SAVE_SIGNAL_AUTO(SB, S) SAVE_SIGNAL_ASYNC(SB, SB.save(#S), S)
+    #define EXPORT_SIGNAL_AUTO(SB, S) SB.export_signal(#S, S)
 }
 
 #endif // DSP_SIMULATION_BUILDERS_H
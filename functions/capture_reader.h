@@ -0,0 +1,285 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_CAPTURE_READER_H
+#define DSP_SIMULATION_CAPTURE_READER_H
+
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <condition_variable>
+
+#include "functions.h"
+#include "mapped_file.hh"
+
+namespace mechdancer {
+    /// 采集数据的只读视图，去掉帧标记后的采样值
+    /// 采集文件中大于 4096 的值标记一帧的起点，其采样值为原值减 4096
+    class marked_span_t {
+        uint16_t const *_data = nullptr;
+        size_t _size = 0;
+    
+    public:
+        using element_type = uint16_t const;
+        using value_type = uint16_t;
+        
+        constexpr static uint16_t MARKER = 4096;
+        
+        static uint16_t sample_of(uint16_t x) { return x > MARKER ? x - MARKER : x; }
+        
+        class iterator {
+            uint16_t const *_p = nullptr;
+        
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = uint16_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = uint16_t;
+            using pointer = void;
+            
+            iterator() = default;
+            
+            explicit iterator(uint16_t const *p) : _p(p) {}
+            
+            reference operator*() const { return sample_of(*_p); }
+            
+            reference operator[](difference_type n) const { return sample_of(_p[n]); }
+            
+            iterator &operator++() {
+                ++_p;
+                return *this;
+            }
+            
+            iterator operator++(int) { return iterator(_p++); }
+            
+            iterator &operator--() {
+                --_p;
+                return *this;
+            }
+            
+            iterator operator--(int) { return iterator(_p--); }
+            
+            iterator &operator+=(difference_type n) {
+                _p += n;
+                return *this;
+            }
+            
+            iterator &operator-=(difference_type n) {
+                _p -= n;
+                return *this;
+            }
+            
+            iterator operator+(difference_type n) const { return iterator(_p + n); }
+            
+            friend iterator operator+(difference_type n, iterator const &p) { return p + n; }
+            
+            iterator operator-(difference_type n) const { return iterator(_p - n); }
+            
+            difference_type operator-(iterator const &others) const { return _p - others._p; }
+            
+            bool operator==(iterator const &others) const { return _p == others._p; }
+            
+            auto operator<=>(iterator const &others) const { return _p <=> others._p; }
+        };
+        
+        using const_iterator = iterator;
+        
+        marked_span_t() = default;
+        
+        marked_span_t(uint16_t const *data, size_t size) : _data(data), _size(size) {}
+        
+        [[nodiscard]] size_t size() const { return _size; }
+        
+        [[nodiscard]] bool empty() const { return _size == 0; }
+        
+        /// 带标记的原始数据
+        [[nodiscard]] uint16_t const *raw() const { return _data; }
+        
+        uint16_t operator[](size_t i) const { return sample_of(_data[i]); }
+        
+        uint16_t front() const { return sample_of(_data[0]); }
+        
+        uint16_t back() const { return sample_of(_data[_size - 1]); }
+        
+        iterator begin() const { return iterator(_data); }
+        
+        iterator end() const { return iterator(_data + _size); }
+        
+        marked_span_t subspan(size_t offset, size_t count) const { return {_data + offset, count}; }
+    };
+    
+    /// 内存映射的采集文件读取器
+    /// 构造后立即在后台分块并行地建立帧索引，文件内容不复制到堆上；
+    /// 索引按块的顺序逐步公布，前面的帧确定后即可开始处理，不必等整个文件扫描完。
+    /// 每帧以不复制数据的信号视图给出，起始时间为其首个采样相对文件开头的时刻，由采样序号以双精度换算；
+    /// time_t 为单精度时时刻只有约 7 位有效数字，需要精确到采样时用 frame_t::offset
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    template<Frequency frequency_t, Time time_t>
+    class capture_reader_t {
+    public:
+        /// 帧索引
+        struct frame_t {
+            size_t offset, length; // 起点序号、采样数（到下一帧起点为止）
+            uint16_t marker;       // 起点处带标记的原值
+        };
+        
+        using view_t = signal_view_t<uint16_t const, frequency_t, time_t, marked_span_t>;
+    
+    private:
+        mapped_file_t _file;
+        std::span<uint16_t const> _samples;
+        frequency_t _fs;
+        time_t _origin;
+        size_t _chunk;
+        
+        std::vector<std::vector<size_t>> _found; // 各块中的帧起点
+        std::vector<bool> _done;
+        std::vector<size_t> _markers;            // 已公布的帧起点
+        size_t _published = 0;                   // 已公布的块数
+        mutable std::mutex _mutex;
+        mutable std::condition_variable _signal;
+        
+        std::atomic<size_t> _next{0};
+        std::vector<std::thread> _workers;
+        
+        [[nodiscard]] size_t chunks() const { return _found.size(); }
+        
+        [[nodiscard]] bool finished_locked() const { return _published == chunks(); }
+        
+        /// 帧 i 的范围已确定
+        [[nodiscard]] bool known_locked(size_t i) const {
+            return i + 1 < _markers.size() || (finished_locked() && i < _markers.size());
+        }
+        
+        void work() {
+            for (size_t c; (c = _next.fetch_add(1, std::memory_order_relaxed)) < chunks();) {
+                const auto begin = c * _chunk;
+                const auto end = std::min(begin + _chunk, _samples.size());
+                std::vector<size_t> found;
+                for (auto i = begin; i < end; ++i)
+                    if (_samples[i] > marked_span_t::MARKER) found.push_back(i);
+                {
+                    std::lock_guard<std::mutex> _(_mutex);
+                    _found[c] = std::move(found);
+                    _done[c] = true;
+                    // 按块的顺序公布，保证已公布的帧起点有序且连续
+                    for (; _published < chunks() && _done[_published]; ++_published) {
+                        auto &markers = _found[_published];
+                        _markers.insert(_markers.end(), markers.begin(), markers.end());
+                        std::vector<size_t>().swap(markers);
+                    }
+                }
+                _signal.notify_all();
+            }
+        }
+    
+    public:
+        /// 打开采集文件并开始建立索引
+        /// \param path 文件路径
+        /// \param sampling_frequency 采样频率
+        /// \param origin 文件中第 0 个采样的时刻
+        /// \param threads 建立索引的线程数
+        /// \param chunk 每块的采样数
+        capture_reader_t(std::string const &path, frequency_t sampling_frequency, time_t origin,
+                         size_t threads = std::thread::hardware_concurrency(), size_t chunk = size_t{1} << 20)
+            : _file(path),
+              _samples(_file.as<uint16_t>()),
+              _fs(sampling_frequency),
+              _origin(origin),
+              _chunk(std::max<size_t>(chunk, 1)),
+              _found((_samples.size() + _chunk - 1) / _chunk),
+              _done(_found.size(), false) {
+            threads = std::clamp<size_t>(threads, 1, std::max<size_t>(chunks(), 1));
+            for (size_t i = 0; i < threads; ++i) _workers.emplace_back([this] { work(); });
+        }
+        
+        capture_reader_t(capture_reader_t const &) = delete;
+        
+        capture_reader_t &operator=(capture_reader_t const &) = delete;
+        
+        ~capture_reader_t() {
+            _next.store(chunks(), std::memory_order_relaxed);
+            for (auto &worker : _workers) worker.join();
+        }
+        
+        /// 文件中的采样总数
+        [[nodiscard]] size_t size() const { return _samples.size(); }
+        
+        [[nodiscard]] frequency_t sampling_frequency() const { return _fs; }
+        
+        /// 第 index 个采样的时刻，以双精度计算
+        [[nodiscard]] time_t time_of(size_t index) const {
+            using ratio = typename frequency_t::ratio;
+            const auto hz = static_cast<double>(_fs.value) * ratio::num / ratio::den;
+            return _origin + std::chrono::duration_cast<time_t>(std::chrono::duration<double>(static_cast<double>(index) / hz));
+        }
+        
+        /// 索引是否已建立完毕
+        [[nodiscard]] bool finished() const {
+            std::lock_guard<std::mutex> _(_mutex);
+            return finished_locked();
+        }
+        
+        /// 范围已确定的帧数，不等待
+        [[nodiscard]] size_t ready() const {
+            std::lock_guard<std::mutex> _(_mutex);
+            return finished_locked() ? _markers.size() : _markers.empty() ? 0 : _markers.size() - 1;
+        }
+        
+        /// 等待帧 i 的范围确定
+        /// \return 帧是否存在
+        bool wait(size_t i) const {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _signal.wait(lock, [&] { return known_locked(i) || finished_locked(); });
+            return i < _markers.size();
+        }
+        
+        /// 帧 i 的索引，必要时等待
+        [[nodiscard]] frame_t frame(size_t i) const {
+            if (!wait(i)) throw std::out_of_range("frame index is out of range");
+            std::lock_guard<std::mutex> _(_mutex);
+            const auto offset = _markers[i];
+            const auto end = i + 1 < _markers.size() ? _markers[i + 1] : _samples.size();
+            return {offset, end - offset, _samples[offset]};
+        }
+        
+        /// 全部帧的索引，等待索引建立完毕
+        [[nodiscard]] std::vector<frame_t> index() const {
+            std::vector<frame_t> result;
+            for (size_t i = 0; wait(i); ++i) result.push_back(frame(i));
+            return result;
+        }
+        
+        /// 帧 i 的视图，必要时等待
+        /// \param i 帧序号
+        /// \param limit 最多取的采样数
+        [[nodiscard]] view_t view(size_t i, size_t limit = -1) const {
+            auto f = frame(i);
+            return {
+                .values = marked_span_t(_samples.data() + f.offset, std::min(f.length, limit)),
+                .sampling_frequency = _fs,
+                .begin_time = time_of(f.offset),
+            };
+        }
+        
+        /// 按顺序处理每一帧，帧的范围一确定就开始处理
+        /// \tparam fun_t 处理函数类型
+        /// \param fun 处理函数，参数为帧序号和帧视图
+        /// \return 帧数
+        template<class fun_t>
+        size_t for_each_frame(fun_t fun) const {
+            size_t i = 0;
+            for (; wait(i); ++i) fun(i, view(i));
+            return i;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_CAPTURE_READER_H
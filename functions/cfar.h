@@ -0,0 +1,258 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_CFAR_H
+#define DSP_SIMULATION_CFAR_H
+
+#include <cmath>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include "functions.h"
+
+namespace mechdancer {
+    /// CFAR 参考电平的估计方式
+    enum class cfar_mode {
+        cell_averaging,    // 单元平均（CA）：参考单元的均值
+        ordered_statistic, // 有序统计（OS）：参考单元中按分位取的值，不易被相邻回波抬高
+    };
+    
+    /// CFAR 检出的一个峰
+    /// \tparam value_t 数值类型
+    /// \tparam time_t 时间类型
+    template<class value_t, Time time_t>
+    struct cfar_peak_t {
+        size_t index;            // 在信号中的序号
+        time_t time;             // 时刻
+        value_t value, threshold; // 峰值、该处的门限
+    };
+    
+    /// 单元平均 CFAR 在平方律检波（功率）输入、指数分布噪声下给定虚警率的门限系数
+    /// \param pfa 虚警率
+    /// \param cells 参考单元总数
+    /// \return 门限系数
+    inline double ca_cfar_scale(double pfa, size_t cells) {
+        if (!(pfa > 0 && pfa < 1) || cells == 0)
+            throw std::invalid_argument("pfa should be in (0, 1) and cells should be positive");
+        const auto n = static_cast<double>(cells);
+        return n * (std::pow(pfa, -1 / n) - 1);
+    }
+    
+    /// 恒虚警率（CFAR）检测器，从互相关幅值等非负信号中提取多个回波
+    /// 每个单元两侧各跳过 guard 个保护单元，再各取 training 个参考单元估计噪声电平，
+    /// 门限为 scale 乘参考电平；信号两端的参考单元不足时只用存在的单元。
+    /// 连续超过门限的单元合为一个峰，取其中的最大值。
+    /// - 单元平均：由前缀和求滑动窗口和，O(n)，主体循环可以向量化
+    /// - 有序统计：维护有序的参考窗口，每步 O(training)
+    /// 门限与信号比较时每 64 个单元统计一次超过的个数（可以向量化），没有超过的块直接跳过
+    class cfar_t {
+        size_t _guard, _training;
+        double _scale, _rank;
+        cfar_mode _mode;
+        
+        /// 可以复用的缓冲
+        struct workspace_t {
+            std::vector<double> prefix, threshold, window;
+        };
+        
+        /// 计算门限，不足一个参考单元的位置门限为无穷大
+        template<class value_t>
+        void compute(value_t const *x, size_t n, workspace_t &w) const {
+            constexpr static auto INF = std::numeric_limits<double>::infinity();
+            const auto g = _guard, m = _training;
+            w.threshold.resize(n);
+            auto *threshold = w.threshold.data();
+            if (_mode == cfar_mode::cell_averaging) {
+                w.prefix.resize(n + 1);
+                auto *prefix = w.prefix.data();
+                prefix[0] = 0;
+                for (size_t i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + static_cast<double>(x[i]);
+                // 参考单元为 [i - g - m, i - g) 和 [i + g + 1, i + g + m + 1) 与 [0, n) 的交
+                auto edge = [&](size_t i) {
+                    const auto lag_end = i > g ? i - g : 0, lag_begin = i > g + m ? i - g - m : 0;
+                    const auto lead_begin = std::min(i + g + 1, n), lead_end = std::min(i + g + m + 1, n);
+                    const auto count = lag_end - lag_begin + lead_end - lead_begin;
+                    threshold[i] = count
+                                   ? _scale * (prefix[lag_end] - prefix[lag_begin] + prefix[lead_end] - prefix[lead_begin]) / static_cast<double>(count)
+                                   : INF;
+                };
+                // 两侧参考单元都完整的部分
+                const auto begin = g + m, end = n > g + m ? n - g - m : 0;
+                const auto k = _scale / static_cast<double>(2 * m);
+                for (size_t i = 0; i < std::min(begin, n); ++i) edge(i);
+                for (auto i = begin; i < end; ++i)
+                    threshold[i] = k * (prefix[i - g] - prefix[i - g - m] + prefix[i + g + m + 1] - prefix[i + g + 1]);
+                for (auto i = std::max(std::min(begin, n), end); i < n; ++i) edge(i);
+            } else {
+                auto &window = w.window;
+                window.clear();
+                auto rank_of = [&](double v) { return std::lower_bound(window.begin(), window.end(), v); };
+                auto insert = [&](size_t j) {
+                    const auto v = static_cast<double>(x[j]);
+                    window.insert(rank_of(v), v);
+                };
+                auto erase = [&](size_t j) {
+                    window.erase(rank_of(static_cast<double>(x[j])));
+                };
+                // 以 j 替换 k，只移动两者之间的元素
+                auto replace = [&](size_t k, size_t j) {
+                    const auto old = static_cast<double>(x[k]), v = static_cast<double>(x[j]);
+                    const auto p = rank_of(old), q = rank_of(v);
+                    if (q > p) {
+                        std::move(p + 1, q, p);
+                        *(q - 1) = v;
+                    } else {
+                        std::move_backward(q, p, p + 1);
+                        *q = v;
+                    }
+                };
+                for (auto j = g + 1; j < std::min(g + m + 1, n); ++j) insert(j);
+                for (size_t i = 0; i < n; ++i) {
+                    if (window.empty())
+                        threshold[i] = INF;
+                    else {
+                        const auto rank = std::ceil(_rank * static_cast<double>(window.size()));
+                        threshold[i] = _scale * window[std::clamp<size_t>(static_cast<size_t>(rank), 1, window.size()) - 1];
+                    }
+                    // 移到 i + 1：滞后窗口移出 i - g - m、移入 i - g，超前窗口移出 i + g + 1、移入 i + g + m + 1
+                    if (i >= g + m) replace(i - g - m, i - g);
+                    else if (i >= g) insert(i - g);
+                    if (i + g + m + 1 < n) replace(i + g + 1, i + g + m + 1);
+                    else if (i + g + 1 < n) erase(i + g + 1);
+                }
+            }
+        }
+        
+        template<RealSignal _signal_t>
+        auto detect(_signal_t const &signal, workspace_t &w) const {
+            using value_t = typename _signal_t::value_t;
+            using time_t = typename _signal_t::time_t;
+            constexpr static size_t BLOCK = 64;
+            
+            std::vector<cfar_peak_t<value_t, time_t>> result;
+            const auto n = signal.values.size();
+            auto const *x = std::data(signal.values);
+            compute(x, n, w);
+            auto const *threshold = w.threshold.data();
+            
+            auto close = [&](size_t i) {
+                result.push_back({
+                    .index = i,
+                    .time = signal.begin_time + signal.sampling_frequency.template duration_of<time_t>(i),
+                    .value = x[i],
+                    .threshold = static_cast<value_t>(threshold[i]),
+                });
+            };
+            size_t best = 0;
+            bool open = false;
+            for (size_t b = 0; b < n; b += BLOCK) {
+                const auto size = std::min(BLOCK, n - b);
+                size_t count = 0;
+                for (size_t i = 0; i < size; ++i) count += static_cast<double>(x[b + i]) > threshold[b + i];
+                if (count == 0) {
+                    if (open) close(best);
+                    open = false;
+                    continue;
+                }
+                for (auto i = b; i < b + size; ++i)
+                    if (static_cast<double>(x[i]) > threshold[i]) {
+                        if (!open || x[i] > x[best]) best = i;
+                        open = true;
+                    } else if (open) {
+                        close(best);
+                        open = false;
+                    }
+            }
+            if (open) close(best);
+            return result;
+        }
+    
+    public:
+        /// 构造 CFAR 检测器
+        /// \param guard 单侧保护单元数
+        /// \param training 单侧参考单元数
+        /// \param scale 门限系数
+        /// \param mode 参考电平的估计方式
+        /// \param rank 有序统计取的分位，(0, 1]
+        cfar_t(size_t guard, size_t training, double scale,
+               cfar_mode mode = cfar_mode::cell_averaging, double rank = .75)
+            : _guard(guard), _training(training), _scale(scale), _rank(rank), _mode(mode) {
+            if (training == 0)
+                throw std::invalid_argument("training cells should be more than 0");
+            if (!(scale > 0))
+                throw std::invalid_argument("scale should be positive");
+            if (!(rank > 0 && rank <= 1))
+                throw std::invalid_argument("rank should be in (0, 1]");
+        }
+        
+        /// 计算门限
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 信号
+        /// \return 各单元的门限，两侧都没有参考单元的位置为无穷大
+        template<RealSignal _signal_t>
+        owning_signal_t<_signal_t> threshold(_signal_t const &signal) const {
+            using value_t = typename _signal_t::value_t;
+            workspace_t w;
+            compute(std::data(signal.values), signal.values.size(), w);
+            owning_signal_t<_signal_t> result{
+                .values = typename owning_signal_t<_signal_t>::container_t(signal.values.size()),
+                .sampling_frequency = signal.sampling_frequency,
+                .begin_time = signal.begin_time,
+            };
+            std::transform(w.threshold.begin(), w.threshold.end(), result.values.begin(),
+                           [](double x) { return static_cast<value_t>(x); });
+            return result;
+        }
+        
+        /// 检测一个信号中的峰
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 信号，如互相关的幅值
+        /// \return 按时间排列的峰
+        template<RealSignal _signal_t>
+        auto operator()(_signal_t const &signal) const {
+            workspace_t w;
+            return detect(signal, w);
+        }
+        
+        /// 批量检测，各线程复用自己的缓冲
+        /// \tparam container_t 信号容器类型
+        /// \param signals 信号
+        /// \param threads 线程数
+        /// \return 各信号中的峰
+        template<class container_t> requires RealSignal<typename container_t::value_type>
+        auto operator()(container_t const &signals, size_t threads = std::thread::hardware_concurrency()) const {
+            using peaks_t = decltype(detect(*std::begin(signals), std::declval<workspace_t &>()));
+            std::vector<peaks_t> result(std::size(signals));
+            std::vector<typename container_t::value_type const *> items;
+            for (auto const &signal : signals) items.push_back(&signal);
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            std::atomic<bool> failed{false};
+            auto work = [&] {
+                try {
+                    workspace_t w;
+                    for (size_t i; !failed.load(std::memory_order_relaxed) && (i = next.fetch_add(1, std::memory_order_relaxed)) < items.size();)
+                        result[i] = detect(*items[i], w);
+                } catch (...) {
+                    if (!failed.exchange(true)) error = std::current_exception();
+                }
+            };
+            threads = std::clamp<size_t>(threads, 1, std::max<size_t>(items.size(), 1));
+            std::vector<std::thread> tasks;
+            for (size_t i = 1; i < threads; ++i) tasks.emplace_back(work);
+            work();
+            for (auto &task : tasks) task.join();
+            if (error) std::rethrow_exception(error);
+            return result;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_CFAR_H
@@ -0,0 +1,128 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_CHANNELIZER_H
+#define DSP_SIMULATION_CHANNELIZER_H
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+
+#include "fft.h"
+
+namespace mechdancer {
+    /// 设计多相信道化器的原型低通滤波器（Blackman 窗 sinc）
+    /// \tparam t 系数类型
+    /// \param channels 信道数
+    /// \param taps_per_channel 每个多相分支的抽头数
+    /// \param bandwidth 通带宽度与信道间隔之比，1 为信道相接
+    /// \return 长度为 channels * taps_per_channel 的滤波器系数，直流增益为 1
+    template<Floating t = float>
+    std::vector<t> prototype_lowpass(size_t channels, size_t taps_per_channel, double bandwidth = 1) {
+        const auto n = channels * taps_per_channel;
+        const auto fc = bandwidth / (2.0 * channels);
+        const auto center = (n - 1) / 2.0;
+        auto result = std::vector<t>(n);
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto x = i - center;
+            auto sinc = x == 0 ? 2 * fc : std::sin(2 * PI * fc * x) / (PI * x);
+            auto window = .42 - .5 * std::cos(2 * PI * i / (n - 1)) + .08 * std::cos(4 * PI * i / (n - 1));
+            sum += result[i] = static_cast<t>(sinc * window);
+        }
+        for (auto &h : result) h = static_cast<t>(h / sum);
+        return result;
+    }
+    
+    /// 多相 FFT 信道化器
+    /// 将实信号均匀划分为 channels 个子带，第 k 个子带中心频率为 k fs / channels，
+    /// 每个输出时刻只做一次 channels 点 FFT。抽取倍数等于信道数时为临界采样，小于信道数时为过采样。
+    /// 对同一个对象多次调用时状态延续，可以分块流式处理
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class channelizer_t {
+        size_t _channels, _decimation;
+        std::vector<t> _prototype;
+        std::vector<t> _history;
+        size_t _count = 0;
+    
+    public:
+        /// 构造信道化器
+        /// \param prototype 原型低通滤波器，不能为空，长度不足信道数整数倍时补 0
+        /// \param channels 信道数，必须为不小于 4 的 2 的幂
+        /// \param decimation 抽取倍数，必须整除信道数
+        channelizer_t(std::vector<t> prototype, size_t channels, size_t decimation)
+            : _channels(channels),
+              _decimation(decimation),
+              _prototype(std::move(prototype)) {
+            if (_prototype.empty())
+                throw std::invalid_argument("prototype filter should not be empty");
+            if (channels < 4 || enlarge_to_2_power(channels) != channels)
+                throw std::invalid_argument("channels should be a power of 2 no less than 4");
+            if (decimation == 0 || channels % decimation != 0)
+                throw std::invalid_argument("decimation should divide channels");
+            _prototype.resize((_prototype.size() + channels - 1) / channels * channels, t{});
+            _history.resize(_prototype.size() - 1, t{});
+        }
+        
+        [[nodiscard]] size_t channels() const { return _channels; }
+        
+        [[nodiscard]] size_t decimation() const { return _decimation; }
+        
+        /// 信道化
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 输入信号
+        /// \return 各信道的复基带信号，采样频率为输入的 1/decimation
+        template<RealSignal _signal_t>
+        auto operator()(_signal_t const &signal) {
+            using time_t = typename _signal_t::time_t;
+            using result_t = signal_t<complex_t<t>, typename _signal_t::frequency_t, time_t>;
+            
+            const auto m = _channels;
+            const auto length = _prototype.size();
+            const auto n = signal.values.size();
+            // 历史采样与本块拼接，x[i] 对应绝对序号 _count - (length - 1) + i
+            auto x = _history;
+            x.reserve(x.size() + n);
+            for (auto v : signal.values) x.push_back(static_cast<t>(v));
+            // 本块中第一个输出时刻
+            const auto first = (_decimation - _count % _decimation) % _decimation;
+            const auto outputs = n > first ? (n - first + _decimation - 1) / _decimation : 0;
+            auto result = std::vector<result_t>(m, result_t{
+                .values = std::vector<complex_t<t>>(outputs),
+                .sampling_frequency = signal.sampling_frequency / _decimation,
+                .begin_time = signal.begin_time + signal.sampling_frequency.template duration_of<time_t>(first),
+            });
+            auto branches = std::vector<complex_t<t>>(m);
+            auto sums = std::vector<t>(m);
+            for (size_t j = 0; j < outputs; ++j) {
+                const auto i = first + j * _decimation;
+                // 多相分支：v[p] = Σ_q h[p + qM] x[n - p - qM]
+                std::fill(sums.begin(), sums.end(), t{});
+                const auto *newest = x.data() + (length - 1) + i;
+                for (size_t q = 0; q < length; q += m) {
+                    const auto *h = _prototype.data() + q;
+                    const auto *s = newest - q;
+                    for (size_t p = 0; p < m; ++p) sums[p] += h[p] * s[-static_cast<std::ptrdiff_t>(p)];
+                }
+                std::transform(sums.begin(), sums.end(), branches.begin(), [](auto v) { return complex_t<t>(v); });
+                // Σ_p v[p] e^{j2πkp/M}，fft 的核即为 e^{+jωn}
+                fft(branches);
+                // 补偿 e^{-j2πkn/M}
+                const auto shift = (_count + i) % m;
+                for (size_t k = 0; k < m; ++k) {
+                    auto z = branches[k];
+                    if (shift) z *= i_omega<t>(static_cast<unsigned>(k * shift % m), static_cast<unsigned>(m));
+                    result[k].values[j] = z;
+                }
+            }
+            // 保留最近的 length - 1 个采样
+            std::copy(x.end() - (length - 1), x.end(), _history.begin());
+            _count += n;
+            return result;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_CHANNELIZER_H
@@ -0,0 +1,172 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_DDC_H
+#define DSP_SIMULATION_DDC_H
+
+#include <optional>
+
+#include "iir.h"
+
+namespace mechdancer {
+    /// 数控振荡器，以复数旋转递推产生 e^{jωn}
+    class nco_t {
+        constexpr static unsigned RENORMALIZE = 1024;
+        
+        complex_t<double> _phasor, _step;
+        unsigned _count = 0;
+    
+    public:
+        /// 构造数控振荡器
+        /// \tparam f_t 频率类型
+        /// \tparam fs_t 采样频率类型
+        /// \param f 振荡频率，可以为负
+        /// \param fs 采样频率
+        /// \param phase 初相位
+        template<Frequency f_t, Frequency fs_t>
+        nco_t(f_t f, fs_t fs, double phase = 0)
+            : _phasor(complex_t<double>::exp(phase)),
+              _step(complex_t<double>::exp(2 * PI * f.template cast_to<Hz_t>().value / fs.template cast_to<Hz_t>().value)) {}
+        
+        /// 输出当前值并前进一步
+        complex_t<double> operator()() {
+            auto result = _phasor;
+            _phasor *= _step;
+            // 定期归一化，抑制递推误差累积
+            if (++_count == RENORMALIZE) {
+                _count = 0;
+                _phasor = _phasor.normalize();
+            }
+            return result;
+        }
+    };
+    
+    /// 数字下变频器：复混频、低通、抽取在一次遍历中完成
+    /// 对同一个对象多次调用时，振荡器、滤波器和抽取相位都会延续，可以分块流式处理
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class ddc_t {
+        nco_t _nco;
+        sos_bank_t<t> _lowpass;
+        std::optional<sos_filter_t<t>> _prefilter;
+        size_t _decimation, _skip = 0;
+    
+    public:
+        /// 构造数字下变频器
+        /// \tparam f_t 频率类型
+        /// \tparam fs_t 采样频率类型
+        /// \param carrier 载波频率，此频率搬移到 0
+        /// \param cutoff 基带低通截止频率
+        /// \param decimation 抽取倍数
+        /// \param fs 输入采样频率
+        /// \param prefilter 混频前对实信号施加的滤波器（如选带的带通）
+        /// \param phase 本振初相位
+        /// \param order 基带低通阶数
+        template<Frequency f_t, Frequency fs_t>
+        ddc_t(f_t carrier, f_t cutoff, size_t decimation, fs_t fs,
+              std::optional<sos_filter_t<t>> prefilter = std::nullopt,
+              double phase = 0, unsigned order = 4)
+            : _nco(-carrier, fs, -phase),
+              _lowpass(butterworth_lowpass<t>(order, cutoff, fs).sections(), 2),
+              _prefilter(std::move(prefilter)),
+              _decimation(decimation) {
+            if (decimation == 0) throw std::invalid_argument("decimation should be positive");
+        }
+        
+        /// 下变频
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 输入信号
+        /// \return 复基带信号，采样频率为输入的 1/decimation
+        template<RealSignal _signal_t>
+        auto operator()(_signal_t const &signal) {
+            using namespace std::chrono;
+            using time_t = typename _signal_t::time_t;
+            using result_t = signal_t<complex_t<t>, typename _signal_t::frequency_t, time_t>;
+            
+            const auto n = signal.values.size();
+            const auto first = std::min(_skip, n);
+            auto result = result_t{
+                .values = std::vector<complex_t<t>>(n > _skip ? (n - _skip + _decimation - 1) / _decimation : 0),
+                .sampling_frequency = signal.sampling_frequency / _decimation,
+                .begin_time = signal.begin_time + signal.sampling_frequency.template duration_of<time_t>(first),
+            };
+            auto q = result.values.begin();
+            for (auto x : signal.values) {
+                auto v = static_cast<t>(x);
+                if (_prefilter) v = (*_prefilter)(v);
+                auto z = _nco() * v;
+                t iq[]{static_cast<t>(z.re), static_cast<t>(z.im)};
+                _lowpass(iq, iq);
+                if (_skip == 0) {
+                    *q++ = {iq[0], iq[1]};
+                    _skip = _decimation;
+                }
+                --_skip;
+            }
+            return result;
+        }
+    };
+    
+    /// 数字上变频器：插值、低通、复混频在一次遍历中完成，输出 2 Re{z e^{jωn}}
+    /// 与 ddc_t 互逆：同载波、同截止频率的上下变频近似恢复原带通信号
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class duc_t {
+        nco_t _nco;
+        sos_bank_t<t> _lowpass;
+        std::optional<sos_filter_t<t>> _postfilter;
+        size_t _interpolation;
+    
+    public:
+        /// 构造数字上变频器
+        /// \tparam f_t 频率类型
+        /// \tparam fs_t 采样频率类型
+        /// \param carrier 载波频率，0 频搬移到此频率
+        /// \param cutoff 基带低通截止频率
+        /// \param interpolation 插值倍数
+        /// \param fs 输出采样频率
+        /// \param postfilter 混频后对实信号施加的滤波器（如选边带的带通）
+        /// \param phase 本振初相位
+        /// \param order 基带低通阶数
+        template<Frequency f_t, Frequency fs_t>
+        duc_t(f_t carrier, f_t cutoff, size_t interpolation, fs_t fs,
+              std::optional<sos_filter_t<t>> postfilter = std::nullopt,
+              double phase = 0, unsigned order = 4)
+            : _nco(carrier, fs, phase),
+              _lowpass(butterworth_lowpass<t>(order, cutoff, fs).sections(), 2),
+              _postfilter(std::move(postfilter)),
+              _interpolation(interpolation) {
+            if (interpolation == 0) throw std::invalid_argument("interpolation should be positive");
+        }
+        
+        /// 上变频
+        /// \tparam _signal_t 信号类型，实信号视为虚部为 0 的复基带信号
+        /// \param signal 基带信号
+        /// \return 实带通信号，采样频率为输入的 interpolation 倍
+        template<Signal _signal_t>
+        auto operator()(_signal_t const &signal) {
+            using result_t = signal_t<t, typename _signal_t::frequency_t, typename _signal_t::time_t>;
+            
+            auto result = result_t{
+                .values = std::vector<t>(signal.values.size() * _interpolation),
+                .sampling_frequency = signal.sampling_frequency * _interpolation,
+                .begin_time = signal.begin_time,
+            };
+            auto q = result.values.begin();
+            for (auto const &x : signal.values) {
+                auto z = complex_t<t>(x) * static_cast<t>(_interpolation);
+                for (size_t i = 0; i < _interpolation; ++i) {
+                    t iq[]{i ? t{} : z.re, i ? t{} : z.im};
+                    _lowpass(iq, iq);
+                    auto y = _nco() * complex_t<double>(iq[0], iq[1]);
+                    auto v = static_cast<t>(2 * y.re);
+                    *q++ = _postfilter ? (*_postfilter)(v) : v;
+                }
+            }
+            return result;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_DDC_H
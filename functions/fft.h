@@ -14,19 +14,19 @@
 #include "functions.h"
 
 namespace mechdancer {
-    /// ʹͽиҶ任ʱķŴ
-    /// \tparam t 
+    /// 使用整型进行傅里叶变换时的放大倍数
+    /// \tparam t 整型
     template<Integer t>
     constexpr static t omega_times = std::numeric_limits<t>::max() >> (sizeof(t) * 4);
     
-    ///   Լ FFT 
+    /// 缓存 Ω 以加速 FFT 运算
     static std::vector<double> MEMORY;
     
-    /// 任 _n^k
-    /// \tparam t ֵ
+    /// 用于正变换的 Ω_n^k
+    /// \tparam t 复数值数据类型
     /// \param k k
     /// \param n n
-    /// \return _n^k
+    /// \return Ω_n^k
     template<Number t>
     static complex_t<t> omega(unsigned k, unsigned n) {
         auto quarter = n / 4;
@@ -63,37 +63,38 @@ namespace mechdancer {
             return {result.re, result.im};
     }
     
-    /// ڷ任 _n^k
-    /// \tparam t ֵ
+    /// 用于反变换的 Ω_n^k
+    /// \tparam t 复数值数据类型
     /// \param k k
     /// \param n n
-    /// \return _n^k
+    /// \return Ω_n^k
     template<Number t>
     static complex_t<t> i_omega(unsigned k, unsigned n) {
         return omega<t>(k, n).conjugate();
     }
     
-    /// fft 
+    /// fft 操作
     enum class fft_operation { fft, ifft };
     
-    ///  2 ٸҶ任
-    /// \tparam operation fft 
-    /// \tparam t 
-    /// \param memory źݿռ
-    template<fft_operation operation = fft_operation::fft, Number t = float>
-    void fft(std::vector<complex_t<t>> &memory) {
-        // ڶ϶ʹ 
-        constexpr static auto  = operation == fft_operation::fft ? omega<t> : i_omega<t>;
+    /// 基 2 快速傅里叶变换
+    /// \tparam operation fft 操作
+    /// \tparam t 复数数据类型
+    /// \tparam allocator_t 分配器类型
+    /// \param memory 信号数据空间
+    template<fft_operation operation = fft_operation::fft, Number t = float, class allocator_t>
+    void fft(std::vector<complex_t<t>, allocator_t> &memory) {
+        // 编译期断定使用哪种 Ω
+        constexpr static auto Ω = operation == fft_operation::fft ? omega<t> : i_omega<t>;
         
-        // ߴ絽 2 ݣԽл 2 FFT
+        // 扩大尺寸到 2 的幂（以进行基 2 FFT）
         auto n = enlarge_to_2_power(memory.size());
         memory.resize(n, memory.back());
-        // 
+        // 错序
         for (size_t i = 0, j = 0; i < n; ++i) {
             if (i > j) std::swap(memory[i], memory[j]);
             for (size_t l = n >> 1u; (j ^= l) < l; l >>= 1u);
         }
-        // 任
+        // 变换
         for (size_t m = 1; m < n; m <<= 1u) {
             auto a = memory.data(), b = a + m;
             const auto s = n / m / 2;
@@ -104,9 +105,9 @@ namespace mechdancer {
                     else {
                         complex_t<t> c;
                         if constexpr (std::is_integral_v<t>)
-                            c = *b * (s * j, n) / omega_times<t>;
+                            c = *b * Ω(s * j, n) / omega_times<t>;
                         else
-                            c = *b * (s * j, n);
+                            c = *b * Ω(s * j, n);
                         *b = *a - c;
                         *a += c;
                     }
@@ -116,18 +117,19 @@ namespace mechdancer {
         }
     }
     
-    ///  fft
-    /// \tparam t 
-    /// \param memory źݿռ
-    template<Number t = float>
-    void ifft(std::vector<complex_t<t>> &memory) {
+    /// 反 fft
+    /// \tparam t 复数数据类型
+    /// \tparam allocator_t 分配器类型
+    /// \param memory 信号数据空间
+    template<Number t = float, class allocator_t>
+    void ifft(std::vector<complex_t<t>, allocator_t> &memory) {
         fft<fft_operation::ifft>(memory);
         for (auto n = memory.size(); auto &p : memory) p /= n;
     }
     
-    ///  FFT ǰߵ
-    /// \tparam t 
-    /// \param memory 
+    /// 用于 FFT 的前后颠倒
+    /// \tparam t 数据类型
+    /// \param memory 数据
     template<class t>
     void fft_shift(std::vector<t> &memory) {
         auto n = enlarge_to_2_power(memory.size());
@@ -142,11 +144,11 @@ namespace mechdancer {
         return diff <= std::abs(x + y) * epsilon || diff < std::numeric_limits<t>::min();
     }
     
-    /// Ϊķױ任
-    /// \tparam order 
-    /// \tparam t ֵ
-    /// \param signal 
-    /// \param sqrt_n ȵƽ
+    /// 阶数为整数的分数阶变换
+    /// \tparam order 阶数
+    /// \tparam t 数值类型
+    /// \param signal 数据
+    /// \param sqrt_n 长度的平方根
     template<unsigned order, Number t = float>
     static void frft_special(std::vector<complex_t<t>> &signal, double sqrt_n) {
         static_assert(order == 1 || order == 2 || order == 3, "only for order 1, 2 or 3");
@@ -159,27 +161,27 @@ namespace mechdancer {
             fft_shift(signal);
         } else {
             fft_shift(signal);
-            fft<fft_operation::ifft>(signal); //  ifft ȱ任
+            fft<fft_operation::ifft>(signal); // 免除 ifft 幅度变换
             for (auto &x : signal) x /= sqrt_n;
             fft_shift(signal);
         }
     }
     
-    /// ׸Ҷ任
-    /// \tparam t ֵ
-    /// \tparam order_t 
-    /// \param signal 
-    /// \param order 
+    /// 分数阶傅里叶变换
+    /// \tparam t 数值类型
+    /// \tparam order_t 阶数类型
+    /// \param signal 数据
+    /// \param order 阶数
     template<Floating t = float>
     void frft(std::vector<complex_t<t>> &signal, t order) {
         auto n = enlarge_to_2_power(signal.size());
         signal.resize(n, signal.back());
         auto sqrt_n = std::sqrt(n);
         
-        // 
+        // 解周期性
         while (order < 0) order += 4;
         while (order >= 4) order -= 4;
-        // 
+        // 处理特殊情况
         if (almost_equal<double>(order, 0))
             return;
         if (almost_equal<double>(order, 1)) {
@@ -194,7 +196,7 @@ namespace mechdancer {
             frft_special<3>(signal, sqrt_n);
             return;
         }
-        //  [.5, 1.5)
+        // 归入 [.5, 1.5)
         if (order > 2) {
             order -= 2;
             frft_special<2>(signal, sqrt_n);
@@ -206,7 +208,7 @@ namespace mechdancer {
             order += 1;
             frft_special<3>(signal, sqrt_n);
         }
-        { // ʱƵͬʱֵ
+        { // 时频域同时插值
             signal.resize(2 * n);
             auto p = signal.end(), q = signal.begin() + n;
             while (p != q) {
@@ -216,36 +218,36 @@ namespace mechdancer {
             fft(signal);
             std::fill(signal.begin() + n / 2, signal.end() - n / 2 + 1, complex_t<t>{});
             ifft(signal);
-            signal.resize(8 * n, complex_t<t>{}); // ֱŵ 8nںֵźֻʹǰ 4n
+            signal.resize(8 * n, complex_t<t>{}); // 直接扩张到 8n，用于后续做卷积，插值后的信号只使用前面的 4n
             std::copy(signal.begin(), signal.begin() + 2 * n, signal.begin() + n);
             std::fill(signal.begin(), signal.begin() + n, complex_t<t>{});
         }
-        { //  +  + 
+        { // 乘 + 卷 + 乘
             auto alpha = order * PI / 2;
             auto c1 = PI / 4 / n * -std::tan(alpha / 2);
             auto c2 = PI / 4 / n / std::sin(alpha);
             auto chirp = std::vector<complex_t<float>>(8 * n, complex_t<t>{});
-            // һγ˻ౣͬʱһ
+            // 第一次乘基啁啾，同时构造另一个啁啾
             auto k = .5 - 2 * n;
             for (unsigned i = 0; i < 4 * n; ++i, ++k) {
                 signal[i] *= complex_t<t>::exp(c1 * k * k);
                 chirp[i] = complex_t<t>::exp(c2 * k * k);
             }
-            // һ
+            // 卷一个啁啾
             fft(signal);
             fft(chirp);
             for (unsigned i = 0; i < 8 * n; ++i)
                 signal[i] *= chirp[i];
             ifft(signal);
-            { // ȡͬʱ˵౺У
-                // ̶У
+            { // 抽取，同时乘第三个啁啾和校正项
+                // 计算固定的校正项
                 const auto z = complex_t<t>::exp(alpha / 2 - PI / 4) / (2 * std::sqrtf(n * std::sinf(alpha)));
-                // ʼõѭ
+                // 初始化用到的循环变量
                 auto p = signal.begin();
                 auto q = signal.begin() + 3 * n;
                 auto e = signal.begin() + n;
                 k = .5 - n;
-                // һౣΪһ FFT 
+                // 这里重新算一次啁啾，因为第一次算的随着 FFT 毁灭了
                 for (; p != e; ++p, q += 2, k += 2)
                     *p = *q * complex_t<t>::exp(c1 * k * k) * z;
                 signal.resize(n);
@@ -0,0 +1,300 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_FIR_H
+#define DSP_SIMULATION_FIR_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include "functions.h"
+#include "../types/noise.h"
+
+namespace mechdancer {
+    /// 编译期数学函数，标准库的 <cmath> 在 C++20 中不是 constexpr
+    namespace constexpr_math {
+        constexpr double abs(double x) { return x < 0 ? -x : x; }
+        
+        /// 正弦，先归入 [-π, π] 再按泰勒级数求和
+        constexpr double sin(double x) {
+            x -= 2 * PI * static_cast<long long>(x / (2 * PI));
+            if (x > PI) x -= 2 * PI;
+            if (x < -PI) x += 2 * PI;
+            double term = x, sum = x;
+            for (int i = 1; i < 30; ++i) {
+                term *= -x * x / ((2 * i) * (2 * i + 1));
+                sum += term;
+            }
+            return sum;
+        }
+        
+        constexpr double cos(double x) { return sin(x + PI / 2); }
+        
+        /// 平方根，牛顿迭代
+        constexpr double sqrt(double x) {
+            if (x <= 0) return 0;
+            double y = x > 1 ? x : 1;
+            for (int i = 0; i < 100; ++i) {
+                auto next = (y + x / y) / 2;
+                if (next == y) break;
+                y = next;
+            }
+            return y;
+        }
+        
+        /// 指数，先折半再按泰勒级数求和后平方
+        constexpr double exp(double x) {
+            int halves = 0;
+            while (abs(x) > .5) {
+                x /= 2;
+                ++halves;
+            }
+            double term = 1, sum = 1;
+            for (int i = 1; i < 20; ++i) {
+                term *= x / i;
+                sum += term;
+            }
+            while (halves--) sum *= sum;
+            return sum;
+        }
+        
+        /// 自然对数，牛顿迭代
+        constexpr double log(double x) {
+            if (x <= 0) return 0;
+            double y = 0;
+            for (int i = 0; i < 200; ++i) {
+                auto next = y - 1 + x / exp(y);
+                if (abs(next - y) < 1e-15) break;
+                y = next;
+            }
+            return y;
+        }
+        
+        /// 幂，x 为 0 时结果为 0（y 应为正）
+        constexpr double pow(double x, double y) { return x == 0 ? 0 : exp(y * log(x)); }
+        
+        /// 第一类零阶修正贝塞尔函数
+        constexpr double bessel_i0(double x) {
+            double term = 1, sum = 1;
+            for (int k = 1; k < 50; ++k) {
+                term *= (x / (2 * k)) * (x / (2 * k));
+                sum += term;
+            }
+            return sum;
+        }
+    }
+    
+    /// 加窗 sinc 设计使用的窗函数
+    enum class fir_window { rectangular, hamming, blackman };
+    
+    /// 求窗函数值
+    /// \param window 窗函数
+    /// \param i 序号
+    /// \param n 窗长
+    /// \return 窗函数值
+    constexpr double window_of(fir_window window, size_t i, size_t n) {
+        if (n < 2) return 1;
+        auto x = 2 * PI * i / (n - 1);
+        switch (window) {
+            case fir_window::hamming:
+                return .54 - .46 * constexpr_math::cos(x);
+            case fir_window::blackman:
+                return .42 - .5 * constexpr_math::cos(x) + .08 * constexpr_math::cos(2 * x);
+            default:
+                return 1;
+        }
+    }
+    
+    /// 由阻带衰减求凯泽窗参数 β
+    /// \param attenuation 阻带衰减（dB，正数）
+    /// \return β
+    constexpr double kaiser_beta(double attenuation) {
+        if (attenuation > 50) return .1102 * (attenuation - 8.7);
+        if (attenuation > 21) return .5842 * constexpr_math::pow(attenuation - 21, .4) + .07886 * (attenuation - 21);
+        return 0;
+    }
+    
+    /// 理想带通（低通时 low 为 0）冲激响应乘窗
+    /// \tparam taps 抽头数
+    /// \tparam t 系数类型
+    /// \tparam window_fun_t 窗函数类型
+    /// \param low 归一化下限频率（除以采样频率）
+    /// \param high 归一化上限频率（除以采样频率）
+    /// \param window 窗函数，参数为序号
+    /// \return 系数表，通带中心增益为 1
+    template<size_t taps, Floating t, class window_fun_t>
+    constexpr std::array<t, taps> windowed_sinc(double low, double high, window_fun_t window) {
+        static_assert(taps > 0, "taps should be positive");
+        if (!(0 <= low && low < high && high <= .5))
+            throw std::invalid_argument("band edges should be in [0, fs / 2]");
+        constexpr auto center = (taps - 1) / 2.0;
+        std::array<double, taps> h{};
+        for (size_t i = 0; i < taps; ++i) {
+            auto x = i - center;
+            auto ideal = x == 0
+                         ? 2 * (high - low)
+                         : (constexpr_math::sin(2 * PI * high * x) - constexpr_math::sin(2 * PI * low * x)) / (PI * x);
+            h[i] = ideal * window(i);
+        }
+        // 通带中心增益归一
+        auto f0 = low == 0 ? 0 : (low + high) / 2;
+        double gain = 0;
+        for (size_t i = 0; i < taps; ++i) gain += h[i] * constexpr_math::cos(2 * PI * f0 * (i - center));
+        std::array<t, taps> result{};
+        for (size_t i = 0; i < taps; ++i) result[i] = static_cast<t>(h[i] / gain);
+        return result;
+    }
+    
+    /// 编译期设计加窗 sinc 低通滤波器
+    /// \tparam taps 抽头数
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \param cutoff 截止频率
+    /// \param fs 采样频率
+    /// \param window 窗函数
+    /// \return 系数表
+    template<size_t taps, Floating t = float, Frequency f_t, Frequency fs_t>
+    constexpr std::array<t, taps> windowed_sinc_lowpass(f_t cutoff, fs_t fs, fir_window window = fir_window::hamming) {
+        auto f = static_cast<double>(fs.template cast_to<Hz_t>().value);
+        return windowed_sinc<taps, t>(0, cutoff.template cast_to<Hz_t>().value / f,
+                                      [window](size_t i) { return window_of(window, i, taps); });
+    }
+    
+    /// 编译期设计加窗 sinc 带通滤波器
+    /// \tparam taps 抽头数
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \param low 通带下限
+    /// \param high 通带上限
+    /// \param fs 采样频率
+    /// \param window 窗函数
+    /// \return 系数表
+    template<size_t taps, Floating t = float, Frequency f_t, Frequency fs_t>
+    constexpr std::array<t, taps> windowed_sinc_bandpass(f_t low, f_t high, fs_t fs, fir_window window = fir_window::hamming) {
+        auto f = static_cast<double>(fs.template cast_to<Hz_t>().value);
+        return windowed_sinc<taps, t>(low.template cast_to<Hz_t>().value / f, high.template cast_to<Hz_t>().value / f,
+                                      [window](size_t i) { return window_of(window, i, taps); });
+    }
+    
+    /// 编译期设计凯泽窗带通滤波器，按阻带衰减指标逼近等波纹设计
+    /// \tparam taps 抽头数，过渡带宽约为 (衰减 - 8) / (14.36 taps) 倍采样频率
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \tparam db_value_t 分贝数值类型
+    /// \param low 通带下限，为 0 时为低通
+    /// \param high 通带上限
+    /// \param fs 采样频率
+    /// \param attenuation 阻带衰减
+    /// \return 系数表
+    template<size_t taps, Floating t = float, Frequency f_t, Frequency fs_t, Number db_value_t>
+    constexpr std::array<t, taps> kaiser_bandpass(f_t low, f_t high, fs_t fs, db_t<db_value_t> attenuation) {
+        auto f = static_cast<double>(fs.template cast_to<Hz_t>().value);
+        auto beta = kaiser_beta(attenuation.value);
+        auto i0_beta = constexpr_math::bessel_i0(beta);
+        return windowed_sinc<taps, t>(low.template cast_to<Hz_t>().value / f, high.template cast_to<Hz_t>().value / f,
+                                      [=](size_t i) {
+                                          auto r = taps > 1 ? 2.0 * i / (taps - 1) - 1 : 0;
+                                          return constexpr_math::bessel_i0(beta * constexpr_math::sqrt(1 - r * r)) / i0_beta;
+                                      });
+    }
+    
+    /// 编译期固化的带通滤波器系数表
+    /// \tparam taps 抽头数
+    /// \tparam low 通带下限
+    /// \tparam high 通带上限
+    /// \tparam fs 采样频率
+    /// \tparam t 系数类型
+    template<size_t taps, auto low, auto high, auto fs, Floating t = float>
+    constexpr static auto bandpass_coefficients = windowed_sinc_bandpass<taps, t>(low, high, fs);
+    
+    /// 编译期固化的低通滤波器系数表
+    /// \tparam taps 抽头数
+    /// \tparam cutoff 截止频率
+    /// \tparam fs 采样频率
+    /// \tparam t 系数类型
+    template<size_t taps, auto cutoff, auto fs, Floating t = float>
+    constexpr static auto lowpass_coefficients = windowed_sinc_lowpass<taps, t>(cutoff, fs);
+    
+    /// 定长 FIR 滤波器
+    /// 抽头数为编译期常量，内层循环可以完全展开并向量化
+    /// \tparam t 数值类型，浮点数或定点数
+    /// \tparam taps 抽头数
+    template<class t, size_t taps> requires Floating<t> || FixedPoint<t>
+    class fir_t {
+        std::array<t, taps> _h;
+        std::array<t, 2 * taps> _line{}; // 双写延时线，保证窗口连续
+        size_t _index = 0;
+        
+        /// 系数与输入的点积
+        /// 定点数与 arm_fir_q15/q31 相同：完整乘积在 64 位累加器中累加，最后右移小数位数并饱和
+        /// \param x 取第 k 个抽头对应的输入
+        template<class get_t>
+        constexpr t dot(get_t x) const {
+            if constexpr (FixedPoint<t>) {
+                int64_t sum = 0;
+                for (size_t k = 0; k < taps; ++k) sum += static_cast<int64_t>(_h[k].raw) * x(k).raw;
+                return t::from_raw(sum >> t::fraction);
+            } else {
+                t sum{};
+                for (size_t k = 0; k < taps; ++k) sum += _h[k] * x(k);
+                return sum;
+            }
+        }
+    
+    public:
+        constexpr explicit fir_t(std::array<t, taps> const &coefficients) : _h(coefficients) {}
+        
+        [[nodiscard]] constexpr std::array<t, taps> const &coefficients() const { return _h; }
+        
+        /// 流式处理一个采样
+        /// \param x 输入
+        /// \return 输出
+        constexpr t operator()(t x) {
+            _index = _index == 0 ? taps - 1 : _index - 1;
+            _line[_index] = _line[_index + taps] = x;
+            auto const *line = _line.data() + _index;
+            return dot([line](size_t k) { return line[k]; });
+        }
+        
+        /// 原位滤波整个信号，滤波器状态延续
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 信号
+        template<RealSignal _signal_t>
+        void filter(_signal_t &signal) {
+            using value_t = typename _signal_t::value_t;
+            constexpr static size_t BLOCK = 1024;
+            
+            auto &values = signal.values;
+            // 历史采样按时间正序放在缓冲前部
+            auto buffer = std::vector<t>(taps - 1 + BLOCK);
+            for (size_t k = 0; k + 1 < taps; ++k) buffer[taps - 2 - k] = _line[_index + k];
+            for (size_t begin = 0; begin < values.size(); begin += BLOCK) {
+                auto n = std::min(BLOCK, values.size() - begin);
+                for (size_t i = 0; i < n; ++i) buffer[taps - 1 + i] = static_cast<t>(values[begin + i]);
+                for (size_t i = 0; i < n; ++i) {
+                    auto const *x = buffer.data() + i + taps - 1;
+                    auto sum = dot([x](size_t k) { return x[-static_cast<std::ptrdiff_t>(k)]; });
+                    values[begin + i] = static_cast<value_t>(sum);
+                }
+                std::copy(buffer.begin() + n, buffer.begin() + n + taps - 1, buffer.begin());
+            }
+            // 写回延时线，_line[_index + k] 为倒数第 k + 1 个输入
+            for (size_t k = 0; k + 1 < taps; ++k) _line[k] = _line[k + taps] = buffer[taps - 2 - k];
+            _index = 0;
+        }
+        
+        /// 清空延时线
+        constexpr void reset() {
+            _line.fill(t{});
+            _index = 0;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_FIR_H
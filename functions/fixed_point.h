@@ -0,0 +1,89 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_FIXED_POINT_H
+#define DSP_SIMULATION_FIXED_POINT_H
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "process_real.h"
+#include "../types/noise.h"
+#include "../types/fixed_t.hpp"
+
+namespace mechdancer {
+    /// 定点信号能量的累加器，与 arm_power_q15/q31 的输出相同：
+    /// q15 的乘积完整累加（34.30 格式），q31 的乘积右移 14 位后累加（16.48 格式）
+    /// 循环只有整数乘加，编译器可以展开为向量化的乘加指令
+    /// \tparam t 定点信号类型
+    /// \param signal 信号
+    /// \return 64 位累加器的原始值
+    template<FixedSignal t, class value_t = typename t::value_t>
+    int64_t energy_accumulator(t const &signal) {
+        constexpr static unsigned shift = 2 * value_t::fraction > 48 ? 2 * value_t::fraction - 48 : 0;
+        int64_t sum = 0;
+        for (size_t i = 0; i < signal.values.size(); ++i) {
+            int64_t x = signal.values[i].raw;
+            sum += (x * x) >> shift;
+        }
+        return sum;
+    }
+    
+    /// 计算定点信号能量，按 arm_power_q15/q31 的方式累加，不会逐项饱和
+    /// \tparam t 定点信号类型
+    /// \param signal 信号
+    /// \return 能量值
+    template<FixedSignal t, class value_t = typename t::value_t>
+    double energy(t const &signal) {
+        constexpr static unsigned shift = 2 * value_t::fraction > 48 ? 2 * value_t::fraction - 48 : 0;
+        return static_cast<double>(energy_accumulator(signal)) / static_cast<double>(int64_t{1} << (2 * value_t::fraction - shift));
+    }
+    
+    /// 定点信号的时域互相关，与 arm_correlate_q15/q31 相同：
+    /// 乘积在 64 位累加器中完整累加，最后右移小数位数并饱和（q31 不做输入缩放，长序列需自行预先缩小）。
+    /// 结果的排列、起始时间与频域的 correlation 一致，便于与浮点仿真对照
+    /// \tparam mode 互相关模式，定点数只支持 basic
+    /// \tparam Tr 参考信号类型
+    /// \tparam Ts 目标信号类型
+    /// \param ref 参考信号
+    /// \param signal 目标信号
+    /// \return 互相关信号
+    template<correlation_mode mode = correlation_mode::basic, FixedSignal Tr, FixedSignal Ts>
+    auto correlation(Tr const &ref, Ts const &signal) {
+        static_assert(mode == correlation_mode::basic, "fixed-point correlation only supports the basic mode");
+        static_assert(std::is_same_v<typename Tr::value_t, typename Ts::value_t>, "the two signals should be with same format");
+        using common_t = common_type<Tr, Ts>;
+        
+        using Tx = typename common_t::value_t;
+        using Tf = typename common_t::frequency_t;
+        using Tt = typename common_t::time_t;
+        
+        const auto fs = signal.sampling_frequency.template cast_to<Tf>();
+        if (ref.sampling_frequency.template cast_to<Tf>() != fs)
+            throw std::invalid_argument("the two signals should be with same sampling_frequency");
+        
+        using namespace std::chrono;
+        const auto lr = static_cast<std::ptrdiff_t>(ref.values.size());
+        const auto ls = static_cast<std::ptrdiff_t>(signal.values.size());
+        common_t result{
+            .values = typename common_t::container_t(lr + ls - 1),
+            .sampling_frequency = fs,
+            .begin_time = duration_cast<Tt>(floating_seconds(1) / fs.template cast_to<Hz_t>().value - ref.begin_time),
+        };
+        auto const &r = ref.values;
+        auto const &s = signal.values;
+        // result[lr - 1 + k] = Σ r[n] s[n + k]，k ∈ (-lr, ls)
+        for (auto k = 1 - lr; k < ls; ++k) {
+            const auto begin = std::max<std::ptrdiff_t>(0, -k);
+            const auto end = std::min(lr, ls - k);
+            int64_t sum = 0;
+            for (auto n = begin; n < end; ++n)
+                sum += static_cast<int64_t>(r[n].raw) * s[n + k].raw;
+            result.values[lr - 1 + k] = Tx::from_raw(sum >> Tx::fraction);
+        }
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_FIXED_POINT_H
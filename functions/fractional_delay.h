@@ -0,0 +1,184 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_FRACTIONAL_DELAY_H
+#define DSP_SIMULATION_FRACTIONAL_DELAY_H
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+
+#include "functions.h"
+
+namespace mechdancer {
+    /// Farrow 结构三次拉格朗日插值系数矩阵
+    /// 行对应 μ 的幂次（0 ~ 3），列对应 x[n-1]、x[n]、x[n+1]、x[n+2]
+    constexpr static double FARROW_CUBIC[4][4]{
+        {0, 1, 0, 0},
+        {-1. / 3, -1. / 2, 1, -1. / 6},
+        {1. / 2, -1, 1. / 2, 0},
+        {-1. / 6, 1. / 2, -1. / 2, 1. / 6},
+    };
+    
+    /// 计算 x[n-1] ~ x[n+2] 处的插值权重，插值点位于 n + μ
+    /// \tparam t 数值类型
+    /// \param mu 小数位置 μ ∈ [0, 1]
+    /// \return 4 个插值权重
+    template<Floating t>
+    std::array<t, 4> farrow_weights(t mu) {
+        std::array<t, 4> result{};
+        for (auto i = 0; i < 4; ++i)
+            result[i] = static_cast<t>(((FARROW_CUBIC[3][i] * mu + FARROW_CUBIC[2][i]) * mu + FARROW_CUBIC[1][i]) * mu + FARROW_CUBIC[0][i]);
+        return result;
+    }
+    
+    /// 以 Farrow 结构在 x[n-1] ~ x[n+2] 之间插值
+    /// \tparam t 数值类型
+    /// \param x 指向 x[n-1] 的指针
+    /// \param mu 小数位置 μ ∈ [0, 1]
+    /// \return x(n + μ)
+    template<Floating t>
+    t farrow_cubic(t const *x, t mu) {
+        // 各分支 FIR 输出
+        auto c0 = x[1];
+        auto c1 = static_cast<t>(-x[0] / 3 - x[1] / 2 + x[2] - x[3] / 6);
+        auto c2 = static_cast<t>((x[0] + x[2]) / 2 - x[1]);
+        auto c3 = static_cast<t>((x[3] - x[0]) / 6 + (x[1] - x[2]) / 2);
+        // Horner 求值
+        return ((c3 * mu + c2) * mu + c1) * mu + c0;
+    }
+    
+    /// 流式分数延时器
+    /// 延时可以逐样本改变，最小为 1 个采样点，最大为构造时指定的长度
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class fractional_delay_t {
+        std::vector<t> _buffer;
+        size_t _mask, _count = 0;
+    
+    public:
+        /// 构造分数延时器
+        /// \param max_delay 最大延时采样点数
+        explicit fractional_delay_t(size_t max_delay)
+            : _buffer(enlarge_to_2_power(max_delay + 4), t{}),
+              _mask(_buffer.size() - 1) {}
+        
+        /// 输入一个采样，并输出延时后的采样
+        /// \param x 输入采样
+        /// \param delay 以采样点计的延时，d ∈ [1, max_delay]
+        /// \return x(k - d)
+        t operator()(t x, t delay) {
+            if (delay < 1 || delay > _buffer.size() - 4)
+                throw std::invalid_argument("delay is out of range");
+            auto k = _count++;
+            _buffer[k & _mask] = x;
+            // 令 d = D + f，k - d = (k - D - 1) + (1 - f)，即 n = k - D - 1，μ = 1 - f ∈ (0, 1]，保证 n + 2 <= k
+            // 整数部分只用整数运算，计数再大也不损失精度
+            auto whole = std::floor(delay);
+            auto n = static_cast<long long>(k) - static_cast<long long>(whole) - 1;
+            auto mu = 1 - (delay - whole);
+            std::array<t, 4> window{};
+            for (auto i = 0; i < 4; ++i)
+                if (auto j = n - 1 + i; j >= 0)
+                    window[i] = _buffer[j & _mask];
+            return farrow_cubic(window.data(), mu);
+        }
+        
+        /// 清空延时线
+        void reset() {
+            std::fill(_buffer.begin(), _buffer.end(), t{});
+            _count = 0;
+        }
+    };
+    
+    /// 对信号施加固定延时
+    /// 延时的整数部分体现在起始时间上，小数部分由固定系数的 4 阶 FIR 实现，
+    /// 输出的采样点仍与原信号的采样网格对齐
+    /// \tparam _signal_t 实信号类型
+    /// \tparam delay_t 时间类型
+    /// \param signal 原信号
+    /// \param time 延时，可以为负
+    /// \return 延时后的信号
+    template<RealSignal _signal_t, Time delay_t>
+    owning_signal_t<_signal_t> delay(_signal_t const &signal, delay_t time) {
+        using value_t = typename _signal_t::value_t;
+        using time_t = typename _signal_t::time_t;
+        static_assert(std::is_floating_point_v<value_t>, "fractional delay needs floating point values");
+        
+        const auto fs = signal.sampling_frequency.template cast_to<Hz_t>().value;
+        const auto d = static_cast<double>(floating_seconds(time).count()) * fs;
+        const auto m = std::floor(d);
+        const auto f = static_cast<value_t>(d - m);
+        
+        owning_signal_t<_signal_t> result{
+            .values = {signal.values.begin(), signal.values.end()},
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time + std::chrono::duration_cast<time_t>(floating_seconds(m / fs)),
+        };
+        if (f == 0 || signal.values.empty()) return result;
+        // y[j] = x(j - f) = x((j - 1) + (1 - f))，即 x[j-2] ~ x[j+1] 上的固定插值
+        const auto h = farrow_weights<value_t>(1 - f);
+        const auto &x = signal.values;
+        const auto n = static_cast<long long>(x.size());
+        auto &y = result.values;
+        y.resize(x.size() + 1);
+        auto at = [&](long long i) { return i >= 0 && i < n ? x[i] : value_t{}; };
+        auto edge = [&](long long j) { return h[0] * at(j - 2) + h[1] * at(j - 1) + h[2] * at(j) + h[3] * at(j + 1); };
+        // 边界
+        for (long long j = 0; j < std::min<long long>(2, n + 1); ++j) y[j] = edge(j);
+        for (long long j = std::max<long long>(2, n - 1); j <= n; ++j) y[j] = edge(j);
+        // 内部，连续访存，可以向量化
+        const auto *p = x.data();
+        for (long long j = 2; j < n - 1; ++j)
+            y[j] = h[0] * p[j - 2] + h[1] * p[j - 1] + h[2] * p[j] + h[3] * p[j + 1];
+        return result;
+    }
+    
+    /// 对信号施加时变延时
+    /// 输出与原信号采样网格、长度相同，原信号范围之外的采样视为 0
+    /// \tparam _signal_t 实信号类型
+    /// \tparam delay_function_t 延时函数类型，以当前采样时刻为参数，返回延时
+    /// \param signal 原信号
+    /// \param delay_of 延时函数
+    /// \return 延时后的信号
+    template<RealSignal _signal_t, class delay_function_t>
+    requires Time<std::invoke_result_t<delay_function_t, typename _signal_t::time_t>>
+    owning_signal_t<_signal_t> delay(_signal_t const &signal, delay_function_t delay_of) {
+        using value_t = typename _signal_t::value_t;
+        using time_t = typename _signal_t::time_t;
+        static_assert(std::is_floating_point_v<value_t>, "fractional delay needs floating point values");
+        
+        const auto fs = signal.sampling_frequency.template cast_to<Hz_t>().value;
+        const auto dt = 1.0 / fs;
+        const auto &x = signal.values;
+        const auto n = static_cast<long long>(x.size());
+        
+        owning_signal_t<_signal_t> result{
+            .values = typename owning_signal_t<_signal_t>::container_t(x.size()),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        // 先求出所有采样点对应的原信号位置
+        auto positions = std::vector<double>(x.size());
+        for (long long k = 0; k < n; ++k) {
+            auto t = signal.begin_time + std::chrono::duration_cast<time_t>(std::chrono::duration<double>(static_cast<double>(k) * dt));
+            positions[k] = static_cast<double>(k) - floating_seconds(delay_of(t)).count() * fs;
+        }
+        // 再逐点插值：原信号前后各补 4 个 0，下标截断到补零区内，范围外的窗口全为 0，循环没有分支
+        constexpr static long long PAD = 4;
+        auto padded = std::vector<value_t>(x.size() + 2 * PAD);
+        std::copy(x.begin(), x.end(), padded.begin() + PAD);
+        auto const *p = padded.data() + PAD;
+        auto *y = result.values.data();
+        for (long long k = 0; k < n; ++k) {
+            const auto whole = std::floor(positions[k]);
+            const auto i = std::clamp(static_cast<long long>(whole), -3LL, n + 1);
+            y[k] = farrow_cubic(p + i - 1, static_cast<value_t>(positions[k] - whole));
+        }
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_FRACTIONAL_DELAY_H
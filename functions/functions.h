@@ -6,18 +6,22 @@
 #define DSP_SIMULATION_FUNCTIONS_H
 
 #include "../types/signal_t.hpp"
+#include "../types/signal_view_t.hpp"
+#include "../types/fixed_t.hpp"
 
 namespace mechdancer {
-    /// ͬȡͣȡ
+    /// 若两个类型相同，取此类型，否则取第三个类型
     template<class a, class b, class else_then>
     using same_or = std::conditional_t<std::is_same_v<a, b>, a, else_then>;
     
-    /// ʵź͵ĺ
-    template<class t, class u> requires RealSignal<t> && RealSignal<u>
+    /// 两个实信号类型的和类型，两者分配器相同时沿用
+    template<class t, class u, class value_t = decltype(typename t::value_t{} + typename u::value_t{})>
+    requires RealSignal<t> && RealSignal<u>
     using common_type = signal_t<
-        decltype(typename t::value_t{} + typename u::value_t{}),
+        value_t,
         same_or<typename t::frequency_t, typename u::frequency_t, Hz_t>,
-        same_or<typename t::time_t, typename u::time_t, floating_seconds>>;
+        same_or<typename t::time_t, typename u::time_t, floating_seconds>,
+        same_or<allocator_of_t<t, value_t>, allocator_of_t<u, value_t>, std::allocator<value_t>>>;
     
     template<class t> requires Integer<t>
     t enlarge_to_2_power(t value) {
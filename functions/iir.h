@@ -0,0 +1,317 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_IIR_H
+#define DSP_SIMULATION_IIR_H
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+
+#include "functions.h"
+#include "../types/noise.h"
+
+namespace mechdancer {
+    /// 二阶节系数，分母首项归一为 1
+    /// H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    struct biquad_t {
+        t b0, b1, b2, a1, a2;
+        
+        /// 求频率响应
+        /// \param omega 数字角频率
+        /// \return 复增益
+        [[nodiscard]] complex_t<double> response(double omega) const {
+            auto z1 = complex_t<double>::exp(-omega);
+            auto z2 = z1 * z1;
+            return (complex_t<double>(b0) + z1 * b1 + z2 * b2) / (complex_t<double>(1) + z1 * a1 + z2 * a2);
+        }
+    };
+    
+    /// 级联二阶节 IIR 滤波器，每节按直接 II 型转置结构实现
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class sos_filter_t {
+        std::vector<biquad_t<t>> _sections;
+        std::vector<std::array<t, 2>> _states;
+    
+    public:
+        explicit sos_filter_t(std::vector<biquad_t<t>> sections)
+            : _sections(std::move(sections)),
+              _states(_sections.size(), std::array<t, 2>{}) {}
+        
+        [[nodiscard]] std::vector<biquad_t<t>> const &sections() const { return _sections; }
+        
+        /// 流式处理一个采样
+        /// \param x 输入
+        /// \return 输出
+        t operator()(t x) {
+            auto s = _states.data();
+            for (auto const &q : _sections) {
+                auto y = q.b0 * x + (*s)[0];
+                (*s)[0] = q.b1 * x - q.a1 * y + (*s)[1];
+                (*s)[1] = q.b2 * x - q.a2 * y;
+                x = y;
+                ++s;
+            }
+            return x;
+        }
+        
+        /// 原位滤波整个信号，滤波器状态延续
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 信号
+        template<RealSignal _signal_t>
+        void filter(_signal_t &signal) {
+            for (auto &x : signal.values) x = static_cast<typename _signal_t::value_t>((*this)(static_cast<t>(x)));
+        }
+        
+        /// 清空滤波器状态
+        void reset() {
+            std::fill(_states.begin(), _states.end(), std::array<t, 2>{});
+        }
+        
+        /// 求频率响应
+        /// \tparam f_t 频率类型
+        /// \tparam fs_t 采样频率类型
+        /// \param f 频率
+        /// \param fs 采样频率
+        /// \return 复增益
+        template<Frequency f_t, Frequency fs_t>
+        [[nodiscard]] complex_t<double> response(f_t f, fs_t fs) const {
+            auto omega = 2 * PI * f.template cast_to<Hz_t>().value / fs.template cast_to<Hz_t>().value;
+            auto result = complex_t<double>(1);
+            for (auto const &q : _sections) result *= q.response(omega);
+            return result;
+        }
+    };
+    
+    /// 多通道级联二阶节 IIR 滤波器组
+    /// 所有通道使用同一组系数，状态按通道连续存放，每个时刻的计算在通道间向量化
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class sos_bank_t {
+        std::vector<biquad_t<t>> _sections;
+        size_t _channels;
+        std::vector<t> _states; // [节][2][通道]
+    
+    public:
+        sos_bank_t(std::vector<biquad_t<t>> sections, size_t channels)
+            : _sections(std::move(sections)),
+              _channels(channels),
+              _states(_sections.size() * 2 * channels, t{}) {}
+        
+        [[nodiscard]] size_t channels() const { return _channels; }
+        
+        /// 处理所有通道的一个时刻
+        /// \param input 各通道输入，长度为通道数
+        /// \param output 各通道输出，长度为通道数，可以与输入相同
+        void operator()(t const *input, t *output) {
+            const auto c = _channels;
+            if (output != input) std::copy_n(input, c, output);
+            auto s = _states.data();
+            for (auto const &q : _sections) {
+                auto *__restrict s0 = s;
+                auto *__restrict s1 = s + c;
+                for (size_t i = 0; i < c; ++i) {
+                    auto x = output[i];
+                    auto y = q.b0 * x + s0[i];
+                    s0[i] = q.b1 * x - q.a1 * y + s1[i];
+                    s1[i] = q.b2 * x - q.a2 * y;
+                    output[i] = y;
+                }
+                s += 2 * c;
+            }
+        }
+        
+        /// 原位滤波一组信号，每个信号为一个通道，信号长度可以不同
+        /// \tparam _signal_t 实信号类型
+        /// \param signals 信号组，数量必须与通道数相同
+        template<RealSignal _signal_t>
+        void filter(std::vector<_signal_t> &signals) {
+            using value_t = typename _signal_t::value_t;
+            constexpr static size_t BLOCK = 64;
+            
+            if (signals.size() != _channels)
+                throw std::invalid_argument("signals count should be equal to channels");
+            size_t length = 0;
+            for (auto const &s : signals) length = std::max(length, s.values.size());
+            // 按块转置为 [时刻][通道]，块内逐时刻处理
+            auto buffer = std::vector<t>(BLOCK * _channels);
+            for (size_t begin = 0; begin < length; begin += BLOCK) {
+                auto end = std::min(begin + BLOCK, length);
+                for (size_t j = 0; j < _channels; ++j) {
+                    auto const &values = signals[j].values;
+                    for (auto k = begin; k < end; ++k)
+                        buffer[(k - begin) * _channels + j] = k < values.size() ? static_cast<t>(values[k]) : t{};
+                }
+                for (auto k = begin; k < end; ++k) {
+                    auto p = buffer.data() + (k - begin) * _channels;
+                    (*this)(p, p);
+                }
+                for (size_t j = 0; j < _channels; ++j) {
+                    auto &values = signals[j].values;
+                    for (auto k = begin; k < std::min(end, values.size()); ++k)
+                        values[k] = static_cast<value_t>(buffer[(k - begin) * _channels + j]);
+                }
+            }
+        }
+        
+        /// 清空所有通道的滤波器状态
+        void reset() {
+            std::fill(_states.begin(), _states.end(), t{});
+        }
+    };
+    
+    /// 模拟原型低通滤波器的极点（截止角频率为 1）
+    /// 只返回虚部非负的极点，共轭极点省略
+    /// \param order 阶数
+    /// \param ripple 通带波纹，为 0 时为巴特沃斯原型，否则为切比雪夫 I 型原型
+    /// \return 极点
+    inline std::vector<complex_t<double>> analog_prototype(unsigned order, double ripple) {
+        if (order == 0) throw std::invalid_argument("order should be positive");
+        auto a = 1.0, b = 1.0;
+        if (ripple > 0) {
+            auto epsilon = std::sqrt(std::pow(10, ripple / 10) - 1);
+            auto mu = std::asinh(1 / epsilon) / order;
+            a = std::sinh(mu);
+            b = std::cosh(mu);
+        }
+        std::vector<complex_t<double>> result;
+        for (unsigned k = 0; k < (order + 1) / 2; ++k) {
+            auto theta = PI * (2 * k + 1) / (2 * order);
+            auto im = b * std::cos(theta);
+            result.push_back({-a * std::sin(theta), std::abs(im) < 1e-12 ? 0 : im});
+        }
+        return result;
+    }
+    
+    /// 双线性变换
+    inline complex_t<double> bilinear(complex_t<double> s, double fs) {
+        return (complex_t<double>(2 * fs) + s) / (complex_t<double>(2 * fs) - s);
+    }
+    
+    /// 复数平方根
+    inline complex_t<double> complex_sqrt(complex_t<double> z) {
+        return complex_t<double>::exp(z.arg() / 2) * std::sqrt(z.norm());
+    }
+    
+    /// 由一对数字极点和给定分子构造二阶节，并归一化到指定频率处增益为 1
+    template<Floating t>
+    inline biquad_t<t> make_biquad(complex_t<double> z1, complex_t<double> z2, std::array<double, 3> b, double omega) {
+        auto sum = z1 + z2, product = z1 * z2;
+        auto section = biquad_t<double>{b[0], b[1], b[2], -sum.re, product.re};
+        auto k = 1 / section.response(omega).norm();
+        return {static_cast<t>(b[0] * k), static_cast<t>(b[1] * k), static_cast<t>(b[2] * k),
+                static_cast<t>(section.a1), static_cast<t>(section.a2)};
+    }
+    
+    /// 设计带通 IIR 滤波器
+    inline auto design_bandpass(unsigned order, double low, double high, double fs, double ripple) {
+        if (!(0 < low && low < high && high < fs / 2))
+            throw std::invalid_argument("band edges should be in (0, fs / 2)");
+        // 预畸变
+        auto w1 = 2 * fs * std::tan(PI * low / fs);
+        auto w2 = 2 * fs * std::tan(PI * high / fs);
+        auto w0 = std::sqrt(w1 * w2), bw = w2 - w1;
+        auto omega = 2 * std::atan(w0 / (2 * fs));
+        // 低通到带通变换：s^2 - p B s + w0^2 = 0
+        std::vector<std::pair<complex_t<double>, complex_t<double>>> pairs;
+        for (auto p : analog_prototype(order, ripple)) {
+            auto pb = p * bw;
+            auto d = complex_sqrt(pb * pb - complex_t<double>(4 * w0 * w0));
+            auto s1 = (pb + d) / 2, s2 = (pb - d) / 2;
+            auto z1 = bilinear(s1, fs), z2 = bilinear(s2, fs);
+            if (p.im == 0)
+                pairs.emplace_back(z1, z2);
+            else {
+                pairs.emplace_back(z1, z1.conjugate());
+                pairs.emplace_back(z2, z2.conjugate());
+            }
+        }
+        return std::make_pair(pairs, omega);
+    }
+    
+    /// 设计巴特沃斯带通滤波器
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \param order 原型阶数，带通滤波器阶数为其 2 倍，二阶节数与之相同
+    /// \param low 通带下限（-3 dB）
+    /// \param high 通带上限（-3 dB）
+    /// \param fs 采样频率
+    /// \return 滤波器
+    template<Floating t = float, Frequency f_t, Frequency fs_t>
+    sos_filter_t<t> butterworth_bandpass(unsigned order, f_t low, f_t high, fs_t fs) {
+        auto[pairs, omega] = design_bandpass(order,
+                                             low.template cast_to<Hz_t>().value,
+                                             high.template cast_to<Hz_t>().value,
+                                             fs.template cast_to<Hz_t>().value,
+                                             0);
+        std::vector<biquad_t<t>> sections;
+        for (auto[z1, z2] : pairs) sections.push_back(make_biquad<t>(z1, z2, {1, 0, -1}, omega));
+        return sos_filter_t<t>(std::move(sections));
+    }
+    
+    /// 设计切比雪夫 I 型带通滤波器
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \tparam ripple_t 波纹数值类型
+    /// \param order 原型阶数，带通滤波器阶数为其 2 倍，二阶节数与之相同
+    /// \param ripple 通带波纹
+    /// \param low 通带下限（波纹边界）
+    /// \param high 通带上限（波纹边界）
+    /// \param fs 采样频率
+    /// \return 滤波器，通带最大增益为 1
+    template<Floating t = float, Frequency f_t, Frequency fs_t, Number ripple_t>
+    sos_filter_t<t> chebyshev_bandpass(unsigned order, db_t<ripple_t> ripple, f_t low, f_t high, fs_t fs) {
+        if (ripple.value <= 0) throw std::invalid_argument("ripple should be positive");
+        auto[pairs, omega] = design_bandpass(order,
+                                             low.template cast_to<Hz_t>().value,
+                                             high.template cast_to<Hz_t>().value,
+                                             fs.template cast_to<Hz_t>().value,
+                                             ripple.value);
+        std::vector<biquad_t<t>> sections;
+        for (auto[z1, z2] : pairs) sections.push_back(make_biquad<t>(z1, z2, {1, 0, -1}, omega));
+        // 偶数阶切比雪夫滤波器中心频率处于波谷
+        if (order % 2 == 0) {
+            auto k = static_cast<t>(1 / std::sqrt(ripple.to_ratio()));
+            sections.front().b0 *= k;
+            sections.front().b2 *= k;
+        }
+        return sos_filter_t<t>(std::move(sections));
+    }
+    
+    /// 设计巴特沃斯低通滤波器
+    /// \tparam t 系数类型
+    /// \tparam f_t 频率类型
+    /// \tparam fs_t 采样频率类型
+    /// \param order 阶数
+    /// \param cutoff 截止频率（-3 dB）
+    /// \param fs 采样频率
+    /// \return 滤波器
+    template<Floating t = float, Frequency f_t, Frequency fs_t>
+    sos_filter_t<t> butterworth_lowpass(unsigned order, f_t cutoff, fs_t fs) {
+        auto f = fs.template cast_to<Hz_t>().value;
+        auto fc = cutoff.template cast_to<Hz_t>().value;
+        if (!(0 < fc && fc < f / 2))
+            throw std::invalid_argument("cutoff should be in (0, fs / 2)");
+        auto wc = 2 * f * std::tan(PI * fc / f);
+        std::vector<biquad_t<t>> sections;
+        for (auto p : analog_prototype(order, 0)) {
+            auto z = bilinear(p * wc, f);
+            if (p.im == 0) {
+                // 一阶节
+                auto k = (1 - z.re) / 2;
+                sections.push_back({static_cast<t>(k), static_cast<t>(k), 0, static_cast<t>(-z.re), 0});
+            } else
+                sections.push_back(make_biquad<t>(z, z.conjugate(), {1, 2, 1}, 0));
+        }
+        return sos_filter_t<t>(std::move(sections));
+    }
+}
+
+#endif // DSP_SIMULATION_IIR_H
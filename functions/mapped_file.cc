@@ -0,0 +1,101 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "mapped_file.hh"
+
+#include <utility>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+mechdancer::mapped_file_t::mapped_file_t(std::string const &path) {
+    #ifdef _WIN32
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("failed to open " + path);
+    _file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        throw std::runtime_error("failed to get the size of " + path);
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) return;
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) {
+        close();
+        throw std::runtime_error("failed to map " + path);
+    }
+    _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!_data) {
+        close();
+        throw std::runtime_error("failed to map " + path);
+    }
+    #else
+    _file = ::open(path.c_str(), O_RDONLY);
+    if (_file < 0) throw std::runtime_error("failed to open " + path);
+    struct stat status{};
+    if (::fstat(_file, &status) != 0) {
+        close();
+        throw std::runtime_error("failed to get the size of " + path);
+    }
+    _size = static_cast<size_t>(status.st_size);
+    if (_size == 0) return;
+    auto data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _file, 0);
+    if (data == MAP_FAILED) {
+        close();
+        throw std::runtime_error("failed to map " + path);
+    }
+    _data = data;
+    // 采集文件多为顺序扫描，提示内核预读
+    ::madvise(data, _size, MADV_SEQUENTIAL);
+    #endif
+}
+
+mechdancer::mapped_file_t::mapped_file_t(mapped_file_t &&others) noexcept {
+    *this = std::move(others);
+}
+
+mechdancer::mapped_file_t &mechdancer::mapped_file_t::operator=(mapped_file_t &&others) noexcept {
+    if (this != &others) {
+        close();
+        _data = std::exchange(others._data, nullptr);
+        _size = std::exchange(others._size, 0);
+        #ifdef _WIN32
+        _file = std::exchange(others._file, nullptr);
+        _mapping = std::exchange(others._mapping, nullptr);
+        #else
+        _file = std::exchange(others._file, -1);
+        #endif
+    }
+    return *this;
+}
+
+mechdancer::mapped_file_t::~mapped_file_t() {
+    close();
+}
+
+void mechdancer::mapped_file_t::close() noexcept {
+    #ifdef _WIN32
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+    if (_file) CloseHandle(_file);
+    _mapping = _file = nullptr;
+    #else
+    if (_data) ::munmap(const_cast<void *>(_data), _size);
+    if (_file >= 0) ::close(_file);
+    _file = -1;
+    #endif
+    _data = nullptr;
+    _size = 0;
+}
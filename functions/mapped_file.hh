@@ -0,0 +1,54 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_MAPPED_FILE_HH
+#define DSP_SIMULATION_MAPPED_FILE_HH
+
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace mechdancer {
+    /// 只读映射到内存的文件
+    /// 数据由操作系统按需调入，不占用进程的堆内存，多 GB 的采集文件也可以直接访问
+    class mapped_file_t {
+        void const *_data = nullptr;
+        size_t _size = 0;
+        #ifdef _WIN32
+        void *_file = nullptr, *_mapping = nullptr;
+        #else
+        int _file = -1;
+        #endif
+        
+        void close() noexcept;
+    
+    public:
+        /// 映射文件，打开或映射失败时抛出 std::runtime_error
+        explicit mapped_file_t(std::string const &path);
+        
+        mapped_file_t(mapped_file_t const &) = delete;
+        
+        mapped_file_t &operator=(mapped_file_t const &) = delete;
+        
+        mapped_file_t(mapped_file_t &&) noexcept;
+        
+        mapped_file_t &operator=(mapped_file_t &&) noexcept;
+        
+        ~mapped_file_t();
+        
+        [[nodiscard]] void const *data() const { return _data; }
+        
+        /// 文件字节数
+        [[nodiscard]] size_t size() const { return _size; }
+        
+        /// 按元素类型访问，末尾不足一个元素的字节忽略
+        template<class t>
+        [[nodiscard]] std::span<t const> as() const {
+            return {static_cast<t const *>(_data), _size / sizeof(t)};
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_MAPPED_FILE_HH
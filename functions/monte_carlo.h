@@ -0,0 +1,200 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_MONTE_CARLO_H
+#define DSP_SIMULATION_MONTE_CARLO_H
+
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include "../types/noise.h"
+
+namespace mechdancer {
+    /// 增量统计量（Welford 算法），两组统计量可以合并（Chan 等的并行公式）
+    struct running_stats_t {
+        size_t count = 0;
+        double mean = 0, m2 = 0; // 均值、离差平方和
+        
+        void push(double x) {
+            ++count;
+            const auto delta = x - mean;
+            mean += delta / static_cast<double>(count);
+            m2 += delta * (x - mean);
+        }
+        
+        void merge(running_stats_t const &others) {
+            if (others.count == 0) return;
+            if (count == 0) {
+                *this = others;
+                return;
+            }
+            const auto n = static_cast<double>(count + others.count);
+            const auto delta = others.mean - mean;
+            mean += delta * static_cast<double>(others.count) / n;
+            m2 += others.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(others.count) / n;
+            count += others.count;
+        }
+        
+        /// 样本方差
+        [[nodiscard]] double variance() const {
+            return count > 1 ? m2 / static_cast<double>(count - 1) : 0;
+        }
+        
+        [[nodiscard]] double stddev() const { return std::sqrt(variance()); }
+    };
+    
+    /// 一次仿真的参数
+    struct trial_t {
+        size_t point, index; // 信噪比点序号、该点上的仿真序号
+        db_t<> snr;
+        uint64_t seed, stream; // 传给 add_noise/add_noise_measured 的种子和流号，仿真已经并行，线程数应传 1
+    };
+    
+    /// 一个信噪比点上的统计结果
+    struct snr_point_t {
+        db_t<> snr;
+        size_t trials = 0, outliers = 0;
+        running_stats_t error; // 野值以外的误差
+        
+        /// 野值率
+        [[nodiscard]] double outlier_rate() const {
+            return trials ? static_cast<double>(outliers) / static_cast<double>(trials) : 0;
+        }
+        
+        /// 野值以外的均方根误差
+        [[nodiscard]] double rmse() const {
+            return std::sqrt(error.mean * error.mean + error.m2 / static_cast<double>(std::max<size_t>(error.count, 1)));
+        }
+    };
+    
+    /// 信噪比扫描的结果
+    struct snr_sweep_t {
+        std::vector<snr_point_t> points;
+        double seconds = 0; // 墙钟时间
+        
+        [[nodiscard]] size_t trials() const {
+            size_t sum = 0;
+            for (auto const &point : points) sum += point.trials;
+            return sum;
+        }
+        
+        /// 吞吐量，次/秒
+        [[nodiscard]] double trials_per_second() const {
+            return seconds > 0 ? static_cast<double>(trials()) / seconds : 0;
+        }
+    };
+    
+    /// 蒙特卡洛仿真的设置
+    struct monte_carlo_options_t {
+        uint64_t seed = 0;                                           // 总种子，决定全部仿真的噪声
+        double outlier = std::numeric_limits<double>::infinity();    // 误差绝对值超过此值记为野值
+        size_t threads = std::thread::hardware_concurrency();
+    };
+    
+    /// 由总种子和信噪比点序号派生各点的种子（SplitMix64 混合）
+    constexpr uint64_t derive_seed(uint64_t seed, uint64_t point) {
+        auto z = seed + (point + 1) * 0x9E3779B97F4A7C15u;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+        return z ^ (z >> 31);
+    }
+    
+    /// 并行蒙特卡洛信噪比扫描
+    /// 每个信噪比点做 trials 次仿真，仿真分成固定大小的批交给各线程，批内按顺序累计统计量，
+    /// 批的结果按顺序合并；每次仿真的种子只由总种子、点序号和仿真序号决定，
+    /// 因此结果与线程数、调度顺序无关，可以复现。
+    /// 各线程用 make_workspace 构造一次自己的工作区（缓冲、滤波器状态等），在该线程的所有仿真中复用；
+    /// 只读的共享数据（如带频谱缓存的参考信号 cached_signal_t）可以直接由 pipeline 捕获
+    /// \tparam factory_t 工作区构造函数类型
+    /// \tparam pipeline_t 单次仿真函数类型
+    /// \param make_workspace 工作区构造函数，无参数
+    /// \param pipeline 单次仿真函数，参数为工作区和 trial_t，返回误差；非有限值记为野值
+    /// \param snr 信噪比序列
+    /// \param trials 每点的仿真次数
+    /// \param options 设置
+    /// \return 各点的统计结果和吞吐量
+    template<class factory_t, class pipeline_t>
+    snr_sweep_t snr_sweep(factory_t make_workspace, pipeline_t pipeline,
+                          std::vector<db_t<>> const &snr, size_t trials,
+                          monte_carlo_options_t const &options = {}) {
+        constexpr static size_t BATCH = 64;
+        
+        const auto batches = (trials + BATCH - 1) / BATCH;
+        const auto jobs = snr.size() * batches;
+        std::vector<snr_point_t> partial(jobs);
+        std::atomic<size_t> next{0};
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+        
+        auto work = [&] {
+            try {
+                auto workspace = make_workspace();
+                for (size_t job; !failed.load(std::memory_order_relaxed) && (job = next.fetch_add(1, std::memory_order_relaxed)) < jobs;) {
+                    const auto point = job / batches;
+                    const auto begin = job % batches * BATCH;
+                    const auto end = std::min(begin + BATCH, trials);
+                    const auto seed = derive_seed(options.seed, point);
+                    auto &result = partial[job];
+                    for (auto i = begin; i < end; ++i) {
+                        const auto e = static_cast<double>(pipeline(workspace, trial_t{point, i, snr[point], seed, i}));
+                        ++result.trials;
+                        if (std::isfinite(e) && std::abs(e) <= options.outlier)
+                            result.error.push(e);
+                        else
+                            ++result.outliers;
+                    }
+                }
+            } catch (...) {
+                if (!failed.exchange(true)) error = std::current_exception();
+            }
+        };
+        
+        const auto start = std::chrono::steady_clock::now();
+        {
+            const auto threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(jobs, 1));
+            std::vector<std::thread> tasks;
+            for (size_t i = 1; i < threads; ++i) tasks.emplace_back(work);
+            work();
+            for (auto &task : tasks) task.join();
+        }
+        if (error) std::rethrow_exception(error);
+        
+        snr_sweep_t result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (size_t point = 0; point < snr.size(); ++point) {
+            auto &merged = result.points.emplace_back(snr_point_t{.snr = snr[point], .trials = 0, .outliers = 0, .error = {}});
+            for (size_t batch = 0; batch < batches; ++batch) {
+                auto const &part = partial[point * batches + batch];
+                merged.trials += part.trials;
+                merged.outliers += part.outliers;
+                merged.error.merge(part.error);
+            }
+        }
+        return result;
+    }
+    
+    /// 等间隔的信噪比序列
+    /// \param from 起点
+    /// \param to 终点（包含），小于起点时序列递减
+    /// \param step 步长（绝对值）
+    inline std::vector<db_t<>> snr_grid(db_t<> from, db_t<> to, float step) {
+        if (!(step > 0)) throw std::invalid_argument("step should be positive");
+        std::vector<db_t<>> result;
+        const auto span = to.value - from.value;
+        const auto delta = span < 0 ? -step : step;
+        const auto n = static_cast<size_t>(std::floor(std::abs(span) / step + 1e-3f)) + 1;
+        for (size_t i = 0; i < n; ++i) result.push_back({from.value + delta * static_cast<float>(i)});
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_MONTE_CARLO_H
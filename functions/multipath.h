@@ -0,0 +1,211 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_MULTIPATH_H
+#define DSP_SIMULATION_MULTIPATH_H
+
+#include <map>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+
+#include "process_real.h"
+#include "fractional_delay.h"
+#include "../types/philox_t.hpp"
+
+namespace mechdancer {
+    /// 稀疏多径信道，由若干条路径（时延、增益）组成，时延可以不是采样间隔的整数倍
+    /// 作用于信号时，分数时延的路径以 Farrow 三次插值展开为 4 个相邻的整数时延抽头（与 delay 相同），
+    /// 重合的抽头合并；抽头稀疏时逐抽头移位累加，O(n·抽头数)，按输出分块以利用缓存，内层循环可以向量化；
+    /// 抽头稠密、移位累加比 FFT 卷积更慢时自动改用 convolution。
+    /// 输出从最小抽头时延开始，不为公共时延补零，起始时间相应推后
+    /// \tparam t 增益的数值类型
+    template<Floating t = float>
+    struct sparse_channel_t {
+        /// 一条路径
+        struct tap_t {
+            floating_seconds delay;
+            t gain;
+        };
+        
+        std::vector<tap_t> taps;
+        
+        sparse_channel_t() = default;
+        
+        sparse_channel_t(std::initializer_list<tap_t> list) : taps(list) {}
+        
+        /// 增加一条路径
+        sparse_channel_t &add(floating_seconds delay, t gain) {
+            taps.push_back({delay, gain});
+            return *this;
+        }
+        
+        /// 在给定采样率下展开为整数时延抽头，按时延排列
+        /// 与整数相差不到 1e-4 个采样的时延按整数处理，吸收时间换算的舍入误差
+        /// \param fs 采样率
+        /// \return 时延（采样点）、增益
+        template<Frequency frequency_t>
+        std::vector<std::pair<long long, t>> expand(frequency_t fs) const {
+            const auto hz = static_cast<double>(fs.template cast_to<Hz_t>().value);
+            std::map<long long, t> merged;
+            for (auto const &tap : taps) {
+                if (tap.delay.count() < 0)
+                    throw std::invalid_argument("delay of path should not be negative");
+                const auto d = static_cast<double>(tap.delay.count()) * hz;
+                const auto m = static_cast<long long>(std::floor(d));
+                const auto f = d - static_cast<double>(m);
+                if (f < 1e-4) {
+                    merged[m] += tap.gain;
+                } else if (f > 1 - 1e-4) {
+                    merged[m + 1] += tap.gain;
+                } else {
+                    // x(j - m - f) = x((j - m - 1) + (1 - f))，即 x[j-m-2] ~ x[j-m+1] 上的插值
+                    const auto h = farrow_weights<t>(static_cast<t>(1 - f));
+                    for (auto i = 0; i < 4; ++i) merged[m + 2 - i] += tap.gain * h[i];
+                }
+            }
+            return {merged.begin(), merged.end()};
+        }
+        
+        /// 冲激响应，从最小抽头时延开始
+        /// \param fs 采样率
+        /// \return 冲激响应信号
+        template<Frequency frequency_t>
+        auto impulse_response(frequency_t fs) const {
+            return impulse_response<signal_t<t, frequency_t, floating_seconds>>(expand(fs), fs);
+        }
+        
+        /// 使信号通过信道
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 信号
+        /// \return 接收信号，长度为信号长度加最大、最小抽头时延之差
+        template<RealSignal _signal_t>
+        owning_signal_t<_signal_t> operator()(_signal_t const &signal) const {
+            using value_t = typename _signal_t::value_t;
+            using time_t = typename _signal_t::time_t;
+            static_assert(std::is_floating_point_v<value_t>, "multipath channel needs floating point values");
+            constexpr static size_t BLOCK = 4096;
+            
+            const auto fs = signal.sampling_frequency;
+            const auto expanded = expand(fs);
+            const auto n = signal.values.size();
+            if (expanded.empty() || n == 0)
+                return {.values = {}, .sampling_frequency = fs, .begin_time = signal.begin_time};
+            const auto first = expanded.front().first;
+            const auto span = static_cast<size_t>(expanded.back().first - first);
+            const auto size = n + span;
+            // 移位累加约 2 次浮点运算/抽头/采样，FFT 卷积约 3 次长度 N 的复数 FFT 外加逐点乘，系数由实测估计
+            const auto N = static_cast<double>(enlarge_to_2_power(size));
+            if (static_cast<double>(expanded.size()) * static_cast<double>(n) > 20 * N * std::log2(N)) {
+                return convolution(signal, impulse_response<_signal_t>(expanded, fs));
+            }
+            
+            owning_signal_t<_signal_t> result{
+                .values = typename owning_signal_t<_signal_t>::container_t(size),
+                .sampling_frequency = fs,
+                .begin_time = signal.begin_time + begin_of<time_t>(first, fs),
+            };
+            auto const *x = std::data(signal.values);
+            auto *y = result.values.data();
+            for (size_t b = 0; b < size; b += BLOCK) {
+                const auto e = std::min(b + BLOCK, size);
+                for (auto const &[delay, gain] : expanded) {
+                    const auto offset = static_cast<size_t>(delay - first);
+                    const auto w = static_cast<value_t>(gain);
+                    const auto begin = std::max(b, offset), end = std::min(e, offset + n);
+                    auto const *p = x - offset;
+                    for (auto i = begin; i < end; ++i) y[i] += w * p[i];
+                }
+            }
+            return result;
+        }
+    
+    private:
+        /// 整数时延对应的起始时间偏移，时延可以为 -1（分数时延插值用到的超前抽头）
+        template<Time time_t, Frequency frequency_t>
+        static time_t begin_of(long long delay, frequency_t fs) {
+            const auto hz = static_cast<double>(fs.template cast_to<Hz_t>().value);
+            return std::chrono::duration_cast<time_t>(floating_seconds(static_cast<double>(delay) / hz));
+        }
+        
+        template<class _signal_t, Frequency frequency_t>
+        static owning_signal_t<_signal_t> impulse_response(std::vector<std::pair<long long, t>> const &expanded, frequency_t fs) {
+            using value_t = typename _signal_t::value_t;
+            using time_t = typename _signal_t::time_t;
+            owning_signal_t<_signal_t> result{
+                .values = {},
+                .sampling_frequency = fs.template cast_to<typename _signal_t::frequency_t>(),
+                .begin_time = time_t{},
+            };
+            if (expanded.empty()) return result;
+            const auto first = expanded.front().first;
+            result.values.resize(static_cast<size_t>(expanded.back().first - first + 1));
+            result.begin_time = begin_of<time_t>(first, fs);
+            for (auto const &[delay, gain] : expanded)
+                result.values[static_cast<size_t>(delay - first)] = static_cast<value_t>(gain);
+            return result;
+        }
+    };
+    
+    /// 随机多径场景的参数
+    struct multipath_profile_t {
+        size_t paths = 8;                              // 路径数（含直达波）
+        floating_seconds min_delay{0}, max_delay{.02f}; // 时延范围
+        floating_seconds decay{.005f};                 // 功率时延谱的时间常数，平均功率按 exp(-(τ - min_delay) / decay) 衰减
+        bool direct = true;                            // 首条路径是否为时延 min_delay、增益 1 的直达波
+    };
+    
+    /// 生成可复现的随机多径信道
+    /// 第 index 个场景只由种子和 index 决定：时延在范围内均匀分布（Philox），
+    /// 增益为零均值正态分布，标准差按功率时延谱衰减
+    /// \tparam t 增益的数值类型
+    /// \param profile 场景参数
+    /// \param seed 种子
+    /// \param index 场景序号
+    /// \return 多径信道
+    template<Floating t = float>
+    sparse_channel_t<t> random_channel(multipath_profile_t const &profile, uint64_t seed, uint64_t index) {
+        if (profile.max_delay < profile.min_delay || profile.min_delay.count() < 0)
+            throw std::invalid_argument("delay range is invalid");
+        if (!(profile.decay.count() > 0))
+            throw std::invalid_argument("decay should be positive");
+        const auto uniform = philox4x32_t{{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}};
+        const auto gains = normal_sequence_t<double>{seed, index};
+        const auto range = static_cast<double>((profile.max_delay - profile.min_delay).count());
+        sparse_channel_t<t> result;
+        for (size_t k = 0; k < profile.paths; ++k) {
+            if (k == 0 && profile.direct) {
+                result.add(profile.min_delay, 1);
+                continue;
+            }
+            // 计数器第 2 个字的最高位置 1，与 normal_sequence_t 用到的计数器不重合
+            const auto bits = uniform({static_cast<uint32_t>(k), static_cast<uint32_t>(k >> 32) | 0x80000000u,
+                                       static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32)});
+            const auto u = (static_cast<double>(bits[0]) + .5) / 4294967296.0;
+            const auto excess = u * range;
+            const auto sigma = std::exp(-excess / static_cast<double>(profile.decay.count()) / 2);
+            result.add(profile.min_delay + floating_seconds(static_cast<float>(excess)), static_cast<t>(sigma * gains[k]));
+        }
+        return result;
+    }
+    
+    /// 生成一批可复现的随机多径信道，第 i 个与 random_channel(profile, seed, i) 相同
+    /// \tparam t 增益的数值类型
+    /// \param profile 场景参数
+    /// \param count 数量
+    /// \param seed 种子
+    /// \return 多径信道
+    template<Floating t = float>
+    std::vector<sparse_channel_t<t>> random_channels(multipath_profile_t const &profile, size_t count, uint64_t seed) {
+        std::vector<sparse_channel_t<t>> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) result.push_back(random_channel<t>(profile, seed, i));
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_MULTIPATH_H
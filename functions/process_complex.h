@@ -10,30 +10,28 @@
 #include <stdexcept>
 
 #include "functions.h"
+#include "spectrum_cache.h"
 
 namespace mechdancer {
-    /// תضͼʵźƵ
-    /// \tparam target_t ֵͣ׼ƺ֧
-    /// \tparam t ʵź
-    /// \param signal ԭź
-    /// \param size С׳
-    /// \return Ƶ
-    template<Number target_t, RealSignal t>
+    /// 转换到特定类型计算实信号频谱
+    /// \tparam target_t 复数值类型，标准库似乎不支持整数
+    /// \tparam t 实信号类型，或带频谱缓存的实信号类型
+    /// \param signal 原信号
+    /// \param size 最小计算谱长度
+    /// \return 频谱
+    template<Number target_t, SpectrumSource t>
     auto fft(t const &signal, size_t size = 0) {
         using frequency_t = typename t::frequency_t;
         using time_t = typename t::time_t;
         using result_t = signal_t <complex_t<target_t>, frequency_t, time_t>;
         
-        size = enlarge_to_2_power(std::max(signal.values.size(), size));
-        auto result = result_t{
-            .values = std::vector<complex_t < target_t>>(size),
-            .sampling_frequency = signal.sampling_frequency,
-            .begin_time = signal.begin_time,
+        auto const &source = source_of(signal);
+        size = enlarge_to_2_power(std::max(source.values.size(), size));
+        return result_t{
+            .values = spectrum_of<target_t>(signal, size, padding_mode::zero),
+            .sampling_frequency = source.sampling_frequency,
+            .begin_time = source.begin_time,
         };
-        std::transform(signal.values.begin(), signal.values.end(), result.values.begin(),
-                       [](auto x) { return complex_t < target_t > {static_cast<target_t>(x), 0}; });
-        fft(result.values);
-        return result;
     }
     
     template<class t, class u> requires ComplexSignal<t> && Frequency<u>
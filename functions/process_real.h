@@ -13,46 +13,47 @@
 
 #include "fft.h"
 #include "process_complex.h"
+#include "signal_expression.h"
+#include "../types/reductions.h"
 
 namespace mechdancer {
-    /// ֵֵ
-    /// \tparam t 
-    /// \param values 
-    /// \return ֵ
+    /// 求数值向量均值
+    /// \tparam t 数据类型
+    /// \param values 向量
+    /// \return 均值
     template<class t>
     t mean(std::vector<t> const &values) {
-        return std::accumulate(values.begin(), values.end(), t{}) / values.size();
+        return static_cast<t>(sum(values) / values.size());
     }
     
-    /// پ
-    /// \tparam t ʵź
-    /// \param a ź 1
-    /// \param b ź 2
-    /// \param size 㳤
-    /// \return ź
-    template<RealSignal _signal_t>
-    _signal_t convolution(_signal_t const &a, _signal_t const &b, size_t size = 0) {
+    /// 快速卷积
+    /// \tparam Ta 实信号类型，或带频谱缓存的实信号类型
+    /// \tparam Tb 实信号类型，或带频谱缓存的实信号类型
+    /// \param _a 信号 1
+    /// \param _b 信号 2
+    /// \param size 计算长度
+    /// \return 卷积信号
+    template<SpectrumSource Ta, SpectrumSource Tb, class _signal_t = owning_signal_t<source_signal_t<Ta>>>
+    requires std::same_as<_signal_t, owning_signal_t<source_signal_t<Tb>>>
+    _signal_t convolution(Ta const &_a, Tb const &_b, size_t size = 0) {
         using value_t = typename _signal_t::value_t;
-        using spectrum_t = std::vector<complex_t<value_t>>;
+        using spectrum_allocator_t = allocator_of_t<_signal_t, complex_t<value_t>>;
         
+        auto const &a = source_of(_a);
+        auto const &b = source_of(_b);
         if (a.sampling_frequency != b.sampling_frequency)
             throw std::invalid_argument("the two signals should be with same sampling_frequency");
         
         size = enlarge_to_2_power(std::max(a.values.size() + b.values.size() - 1, size));
-        auto A = spectrum_t(size, complex_t<value_t>{}),
-            B = spectrum_t(size, complex_t<value_t>{});
+        auto A = spectrum_of<value_t, spectrum_allocator_t>(_a, size, padding_mode::zero);
+        auto B = spectrum_of<value_t, spectrum_allocator_t>(_b, size, padding_mode::zero);
         
-        std::transform(a.values.begin(), a.values.end(), A.begin(), [](auto x) { return x; });
-        std::transform(b.values.begin(), b.values.end(), B.begin(), [](auto x) { return x; });
-        
-        fft(A);
-        fft(B);
         for (auto p = A.begin(), q = B.begin(); p < A.end(); ++p, ++q) *p *= *q;
         ifft(A);
         
         size = a.values.size() + b.values.size() - 1;
         _signal_t result{
-            .values = std::vector<value_t>(size),
+            .values = typename _signal_t::container_t(size),
             .sampling_frequency = a.sampling_frequency,
             .begin_time = a.begin_time + b.begin_time,
         };
@@ -60,7 +61,7 @@ namespace mechdancer {
         return result;
     }
     
-    /// ģʽ
+    /// 互相关模式
     enum class correlation_mode { basic, phat, noise_reduction };
     
     template<Number t>
@@ -79,15 +80,15 @@ namespace mechdancer {
         return r.conjugate() * s / s.norm();
     }
     
-    /// Ƶ
-    /// \tparam _signal_t ź
-    /// \param ref οź
-    /// \param signal Ŀź
-    /// \param size 㳤
-    /// \return 
-    template<correlation_mode mode = correlation_mode::basic, RealSignal Tr, RealSignal Ts>
-    auto correlation(Tr const &ref, Ts const &signal) {
-        using common_t = common_type<Tr, Ts>;
+    /// 频域互相关
+    /// \tparam Tr 参考信号类型，可以带频谱缓存
+    /// \tparam Ts 目标信号类型，可以带频谱缓存
+    /// \param _ref 参考信号
+    /// \param _signal 目标信号
+    /// \return 互相关谱
+    template<correlation_mode mode = correlation_mode::basic, SpectrumSource Tr, SpectrumSource Ts>
+    auto correlation(Tr const &_ref, Ts const &_signal) {
+        using common_t = common_type<source_signal_t<Tr>, source_signal_t<Ts>>;
         
         using Tx = typename common_t::value_t;
         using Tf = typename common_t::frequency_t;
@@ -100,20 +101,17 @@ namespace mechdancer {
                     ? correlation_phat<Tx>
                     : correlation_noise_reduction<Tx>;
         
+        auto const &ref = source_of(_ref);
+        auto const &signal = source_of(_signal);
         const auto fs = signal.sampling_frequency.template cast_to<Tf>();
         
         if (ref.sampling_frequency.template cast_to<Tf>() != fs)
             throw std::invalid_argument("the two signals should be with same sampling_frequency");
         
         auto size = enlarge_to_2_power(ref.values.size() + signal.values.size() - 1);
-        auto R = std::vector<complex_t<Tx>>(size, complex_t<Tx>(ref.values.back()));
-        auto S = std::vector<complex_t<Tx>>(size, complex_t<Tx>(signal.values.back()));
-        
-        std::transform(ref.values.begin(), ref.values.end(), R.begin(), [](auto x) { return complex_t<Tx>(x); });
-        std::transform(signal.values.begin(), signal.values.end(), S.begin(), [](auto x) { return complex_t<Tx>(x); });
-        
-        fft(R);
-        fft(S);
+        using spectrum_allocator_t = allocator_of_t<common_t, complex_t<Tx>>;
+        auto R = spectrum_of<Tx, spectrum_allocator_t>(_ref, size, padding_mode::hold);
+        auto S = spectrum_of<Tx, spectrum_allocator_t>(_signal, size, padding_mode::hold);
         for (auto p = S.begin(), q = R.begin(); p < S.end(); ++p, ++q)
             if (q->is_zero())
                 *p = {};
@@ -125,7 +123,7 @@ namespace mechdancer {
         auto lr = ref.values.size();
         auto ls = signal.values.size();
         common_t result{
-            .values = std::vector<Tx>(lr + ls - 1),
+            .values = typename common_t::container_t(lr + ls - 1),
             .sampling_frequency = fs,
             .begin_time = duration_cast<Tt>(floating_seconds(1) / fs.template cast_to<Hz_t>().value - ref.begin_time),
         };
@@ -134,37 +132,37 @@ namespace mechdancer {
         return result;
     }
     
-    /// ıز
-    /// \tparam new_frequency_t ²Ƶ
-    /// \tparam new_signal_t ź
-    /// \param new_fs ²
-    /// \param _times ʣԽߣԽ
-    /// \return ź
+    /// 改变采样率重采样
+    /// \tparam new_frequency_t 新采样频率类型
+    /// \tparam new_signal_t 新信号类型
+    /// \param new_fs 新采样率
+    /// \param _times 处理倍率，倍率越高，精度越高
+    /// \return 新信号
     template<RealSignal _signal_t, Frequency new_frequency_t, Number times_t>
     auto resample(_signal_t const &signal, new_frequency_t new_fs, times_t _times) {
         using value_t = typename _signal_t::value_t;
-        using new_signal_t = signal_t<value_t, new_frequency_t, typename _signal_t::time_t>;
+        using new_signal_t = signal_t<value_t, new_frequency_t, typename _signal_t::time_t, allocator_of_t<_signal_t>>;
         
         const auto &values = signal.values;
         
-        // ƵʣƵƵֱͬӷ
+        // 检查新频率，若新频率与旧频率相同，直接返回
         auto old_fs = signal.sampling_frequency.template cast_to<new_frequency_t>();
         if (old_fs == new_fs)
             return new_signal_t{
-                .values = values,
+                .values = typename new_signal_t::container_t(values.begin(), values.end()),
                 .sampling_frequency = new_fs,
                 .begin_time = signal.begin_time,
             };
-        // ڻ 2 ¼ʵزʺͽСҪ߱
+        // 在基 2 条件下计算实际重采样倍率和降采样间隔，若间隔过小，要求提高倍率
         const auto times = enlarge_to_2_power(values.size() * (_times + 1) - 1) / enlarge_to_2_power(values.size());
         const auto interval = static_cast<double>(times) * old_fs.value / new_fs.value;
         const auto max = static_cast<size_t>(signal.values.size() * times / interval + 1) + 1;
         if (interval < 1)
             throw std::invalid_argument("processing times is too little");
-        // Ƿ
+        // 按是否进行升采样分类
         if (times > 1) {
-            //  FFT 
-            auto spectrum = std::vector<complex_t<value_t>>(values.size());
+            // 基于 FFT 升采样
+            auto spectrum = std::vector<complex_t<value_t>, allocator_of_t<_signal_t, complex_t<value_t>>>(values.size());
             std::transform(values.begin(), values.end(), spectrum.begin(), [](value_t x) { return complex_t<value_t>{x, 0}; });
             
             fft(spectrum);
@@ -175,7 +173,7 @@ namespace mechdancer {
             std::fill(spectrum.begin() + size / 2, spectrum.end() - size / 2 + 1, complex_t<value_t>{});
             spectrum[spectrum.size() / 2] = extra;
             ifft(spectrum);
-            // ٽĿ
+            // 再降采样到目标采样率
             new_signal_t result{
                 .sampling_frequency = new_fs,
                 .begin_time =signal.begin_time,
@@ -187,7 +185,7 @@ namespace mechdancer {
             }
             return result;
         } else {
-            // ԭźֱʱ򽵲
+            // 从原信号直接时域降采样，尽量多采
             new_signal_t result{
                 .sampling_frequency = new_fs,
                 .begin_time = signal.begin_time,
@@ -201,58 +199,58 @@ namespace mechdancer {
         }
     }
     
-    /// ϣر任
-    /// \tparam _signal_t ź
-    /// \tparam _value_t źֵ
-    /// \tparam complex_t ֵ
-    /// \tparam new_signal_t źͣźţ
-    /// \param signal ԭź
-    /// \return ϣ
-    template<RealSignal _signal_t,
+    /// 希尔伯特变换
+    /// \tparam source_t 信号类型，可以带频谱缓存
+    /// \tparam _value_t 信号值类型
+    /// \tparam complex_t 复数值类型
+    /// \tparam new_signal_t 新信号类型（复信号）
+    /// \param source 原信号
+    /// \return 希尔伯特谱
+    template<SpectrumSource source_t,
+             class _signal_t = source_signal_t<source_t>,
              class _value_t = typename _signal_t::value_t,
              class new_signal_t = signal_t<
                  complex_t<_value_t>,
                  typename _signal_t::frequency_t,
-                 typename _signal_t::time_t>>
-    new_signal_t hilbert(_signal_t const &signal) {
+                 typename _signal_t::time_t,
+                 allocator_of_t<_signal_t, complex_t<_value_t>>>>
+    new_signal_t hilbert(source_t const &source) {
+        auto const &signal = source_of(source);
         auto size = enlarge_to_2_power(signal.values.size());
-        auto result = std::vector<complex_t<_value_t>>(size, signal.values.back());
-        std::transform(signal.values.begin(), signal.values.end(), result.begin(),
-                       [](auto x) -> complex_t<_value_t> { return x; });
-        // ɳǰ 90 źţ鲿
-        fft(result);
+        // 生成超前 90° 的信号（虚部）
+        auto result = spectrum_of<_value_t, typename new_signal_t::allocator_t>(source, size, padding_mode::hold);
         {
             auto p = result.begin();
-            ++p; // ܿ 0 Ƶʵ㣬ǰһ룬Ƶʲ֣ǰ 90
+            ++p; // 避开 0 频率点，前一半，正频率部分，超前 90°
             while (p < result.begin() + size / 2)
                 *p++ = {-p->im, p->re};
-            ++p; // ܿ 0 Ƶʵ㣬һ룬Ƶʲ֣ͺ 90
+            ++p; // 避开 0 频率点，后一半，负频率部分，滞后 90°
             while (p < result.end())
                 *p++ = {p->im, -p->re};
         }
         ifft(result);
-        // ԭźźϲΪź
+        // 与原信号合并为复信号
         result.resize(signal.values.size());
         auto p = signal.values.begin();
         auto q = result.begin();
         while (p < signal.values.end()) *q++ = {*p++, q->re};
         return new_signal_t{
-            .values = result,
+            .values = typename new_signal_t::container_t(result.begin(), result.end()),
             .sampling_frequency = signal.sampling_frequency,
             .begin_time = signal.begin_time,
         };
     }
     
-    /// ʵƵ
-    /// \tparam t ʵź
-    /// \param signal ʱź
-    /// \return 
+    /// 实倒频谱
+    /// \tparam t 实信号类型
+    /// \param signal 时域信号
+    /// \return 倒谱
     template<RealSignal t>
-    t rceps(t const &signal, size_t size = 0) {
+    owning_signal_t<t> rceps(t const &signal, size_t size = 0) {
         using value_t = typename t::value_t;
-        using spectrum_t = std::vector<complex_t<value_t>>;
+        using spectrum_t = std::vector<complex_t<value_t>, allocator_of_t<t, complex_t<value_t>>>;
         
-        auto spectrum = spectrum_t(2 * enlarge_to_2_power(std::max(signal.values.size(), size)), complex_t<value_t>::zero);
+        auto spectrum = spectrum_t(2 * enlarge_to_2_power(std::max(signal.values.size(), size)), complex_t<value_t>{});
         std::transform(signal.values.begin(), signal.values.end(), spectrum.begin(),
                        [](auto x) { return complex_t<value_t>{x, 0}; });
         fft(spectrum);
@@ -268,8 +266,8 @@ namespace mechdancer {
         };
         ifft(spectrum);
         spectrum.erase(e, spectrum.end());
-        auto result = t{
-            .values = std::vector<value_t>(spectrum.size()),
+        auto result = owning_signal_t<t>{
+            .values = typename owning_signal_t<t>::container_t(spectrum.size()),
             .sampling_frequency = signal.sampling_frequency,
             .begin_time = signal.begin_time,
         };
@@ -278,12 +276,12 @@ namespace mechdancer {
         return result;
     }
     
-    /// ͨ˲
-    /// \tparam t ź
-    /// \tparam u Ƶ
-    /// \param signal ź
-    /// \param min Ƶ
-    /// \param max Ƶ
+    /// 带通滤波
+    /// \tparam t 信号类型
+    /// \tparam u 频率类型
+    /// \param signal 信号
+    /// \param min 频率下限
+    /// \param max 频率上限
     template<class t, class u> requires RealSignal<t> && Frequency<u>
     void bandpass(t &signal, u min, u max) {
         auto spectrum = signal.template cast<complex_t<typename t::value_t>>(0, [](auto x) -> complex_t<typename t::value_t> { return x; });// complex(signal);
@@ -295,45 +293,31 @@ namespace mechdancer {
         std::transform(values.begin(), values.end(), signal.values.begin(), [](auto z) { return z.re; });
     };
     
-    #define OPERATOR(WHAT)                                                                                                            \
-    template<RealSignal t, RealSignal u>                                                                                              \
-    auto operator WHAT(t const &a, u const &b) {                                                                                      \
-        using common_t = common_type<t, u>;                                                                                           \
-                                                                                                                                      \
-        using value_t = typename common_t::value_t;                                                                                   \
-        using frequency_t = typename common_t::frequency_t;                                                                           \
-        using time_t = typename common_t::time_t;                                                                                     \
-                                                                                                                                      \
-        const auto fa = a.sampling_frequency.template cast_to<frequency_t>();                                                         \
-        const auto fb = b.sampling_frequency.template cast_to<frequency_t>();                                                         \
-        if (fa != fb) throw std::invalid_argument("");                                                                                \
-                                                                                                                                      \
-        const auto ta = std::chrono::duration_cast<time_t>(a.begin_time);                                                             \
-        const auto tb = std::chrono::duration_cast<time_t>(b.begin_time);                                                             \
-        auto result = common_t{                                                                                                       \
-            .sampling_frequency = fa,                                                                                                 \
-            .begin_time = std::min(ta, tb),                                                                                           \
-        };                                                                                                                            \
-                                                                                                                                      \
-        const size_t ia = result.sampling_frequency.index_of(ta - result.begin_time);                                                 \
-        const size_t ib = result.sampling_frequency.index_of(tb - result.begin_time);                                                 \
-        result.values.resize(std::max(ia + a.values.size(), ib + b.values.size()));                                                   \
-                                                                                                                                      \
-        std::transform(a.values.begin(), a.values.end(), result.values.begin() + ia, [](auto x) { return static_cast<value_t>(x); }); \
-        auto p = b.values.begin();                                                                                                    \
-        auto q = result.values.begin() + ib;                                                                                          \
-        while (p < b.values.end()) *q++ WHAT= static_cast<value_t>(*p++);                                                             \
-                                                                                                                                      \
-        return result;                                                                                                                \
+    /// 带通滤波，复用缓存的频谱
+    /// \tparam t 带频谱缓存的信号类型
+    /// \tparam u 频率类型
+    /// \param source 信号
+    /// \param min 频率下限
+    /// \param max 频率上限
+    /// \return 滤波后的信号
+    template<class t, class u> requires CachedSignal<t> && Frequency<u>
+    auto bandpass(t const &source, u min, u max) {
+        using value_t = typename t::value_t;
+        using complex_signal_t = signal_t<complex_t<value_t>, typename t::frequency_t, typename t::time_t,
+                                          allocator_of_t<typename t::signal_type, complex_t<value_t>>>;
+        
+        auto result = source.signal();
+        auto spectrum = complex_signal_t{
+            .values = spectrum_of<value_t, typename complex_signal_t::allocator_t>(source, enlarge_to_2_power(result.values.size()), padding_mode::hold),
+            .sampling_frequency = result.sampling_frequency,
+            .begin_time = result.begin_time,
+        };
+        auto &values = spectrum.values;
+        bandpass(spectrum, min, max);
+        ifft(values);
+        std::transform(values.begin(), values.begin() + result.values.size(), result.values.begin(), [](auto z) { return z.re; });
+        return result;
     }
-    
-    OPERATOR(+)
-    
-    OPERATOR(-)
-    
-    OPERATOR(*)
-    
-    #undef OPERATOR
 }
 
 #endif // DSP_SIMULATION_PROCESS_REAL_H
@@ -21,6 +21,11 @@ mechdancer::script_builder_t::script_builder_t(std::string const &path) {
 }
 
 mechdancer::script_builder_t::~script_builder_t() {
+    try {
+        flush();
+    } catch (std::exception const &e) {
+        std::cerr << e.what() << std::endl;
+    }
     std::stringstream builder;
     builder << data_file_path << "matlab_script.txt";
     
@@ -30,18 +35,40 @@ mechdancer::script_builder_t::~script_builder_t() {
     builder << "cd " << data_file_path << std::endl;
     for (auto const &file : files)
         builder << file << " = " << "load(\"" << data_file_path << file << ".txt\");" << std::endl;
+    for (auto const &[name, format] : exports)
+        if (format == binary_format::mat)
+            builder << name << " = " << "load(\"" << data_file_path << name << ".mat\");" << std::endl;
     
     auto text = builder.str();
     std::replace(text.begin(), text.end(), '\\', '/');
     std::cout << std::endl << text;
     script << text;
+    
+    // npz 文件由 Python 脚本读入
+    if (std::none_of(exports.begin(), exports.end(), [](auto const &e) { return e.second == binary_format::npz; }))
+        return;
+    builder.str("");
+    builder << "import numpy as np" << std::endl << std::endl;
+    for (auto const &[name, format] : exports)
+        if (format == binary_format::npz)
+            builder << name << " = " << "dict(np.load(r\"" << data_file_path << name << ".npz\"))" << std::endl;
+    text = builder.str();
+    std::replace(text.begin(), text.end(), '\\', '/');
+    std::ofstream(data_file_path + "python_script.py") << text;
 }
 
 std::string mechdancer::script_builder_t::save(std::string const &file) {
-    files.push_back(file);
+    {
+        std::lock_guard<std::mutex> _(mutex);
+        files.push_back(file);
+    }
     std::stringstream builder;
     builder << data_file_path << file;
     if (std::none_of(file.begin(), file.end(), [](auto c) { return c == '.'; }))
         builder << ".txt";
     return builder.str();
 }
+
+void mechdancer::script_builder_t::flush() {
+    writer.flush();
+}
@@ -5,13 +5,23 @@
 #ifndef DSP_SIMULATION_SCRIPT_BUILDER_HH
 #define DSP_SIMULATION_SCRIPT_BUILDER_HH
 
+#include <mutex>
 #include <string>
 #include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "signal_writer.hh"
+#include "binary_export.h"
+#include "../types/signal_t.hpp"
 
 namespace mechdancer {
     class script_builder_t {
         std::string data_file_path;
         std::vector<std::string> files;
+        std::vector<std::pair<std::string, binary_format>> exports;
+        std::mutex mutex;
+        signal_writer_t writer;
     
     public:
         explicit script_builder_t(std::string const &);
@@ -19,6 +29,46 @@ namespace mechdancer {
         ~script_builder_t();
         
         std::string save(std::string const &);
+        
+        /// 在后台把信号写入文件，提交时复制数据（右值信号直接移交存储）
+        /// \param path 文件路径
+        /// \param signal 信号
+        /// \param formatter 输出格式编码器，参数为输出和采样值
+        template<class t, class formatter_t> requires Signal<std::remove_cvref_t<t>>
+        void save(std::string const &path, t &&signal, formatter_t formatter) {
+            using signal_type = std::remove_cvref_t<t>;
+            using value_t = typename signal_type::value_t;
+            std::vector<value_t> values;
+            if constexpr (!std::is_lvalue_reference_v<t> && requires { requires std::is_same_v<typename signal_type::container_t, std::vector<value_t>>; })
+                values = std::move(signal.values);
+            else
+                values.assign(signal.values.begin(), signal.values.end());
+            writer.submit(path, [values = std::move(values), formatter](text_writer_t &file) {
+                for (auto const &x : values) formatter(file, x);
+            });
+        }
+        
+        /// 在后台把信号以二进制格式写入数据目录，连同采样率和起始时间，
+        /// 生成的脚本中以同名变量读入：MAT 文件由 MATLAB 脚本读入，npz 文件由 Python 脚本读入
+        /// \param name 变量名
+        /// \param signal 信号
+        /// \param format 格式
+        /// \return 文件路径
+        template<class t> requires Signal<std::remove_cvref_t<t>>
+        std::string export_signal(std::string const &name, t &&signal, binary_format format = binary_format::mat) {
+            auto path = data_file_path + name + (format == binary_format::mat ? ".mat" : ".npz");
+            {
+                std::lock_guard<std::mutex> _(mutex);
+                exports.emplace_back(name, format);
+            }
+            writer.submit(path, [exported = exported_signal(std::forward<t>(signal)), format](text_writer_t &file) {
+                write_binary(file, exported, format);
+            });
+            return path;
+        }
+        
+        /// 等待后台的写文件任务全部完成
+        void flush();
     };
 }
 
@@ -0,0 +1,283 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SIGNAL_EXPRESSION_H
+#define DSP_SIMULATION_SIGNAL_EXPRESSION_H
+
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+
+#include "functions.h"
+
+namespace mechdancer {
+    template<class t>
+    struct is_complex : std::false_type {};
+    
+    template<class t>
+    struct is_complex<complex_t<t>> : std::true_type {};
+    
+    /// 可以与信号做逐点运算的标量：实数或复数
+    template<class t>
+    concept Scalar = Number<t> || is_complex<t>::value;
+    
+    /// 取复数的实部类型，实数不变
+    template<class t>
+    struct real_type { using type = t; };
+    
+    template<class t>
+    struct real_type<complex_t<t>> { using type = t; };
+    
+    /// 两个标量类型运算的结果类型，任一为复数时结果为复数
+    template<Scalar a, Scalar b>
+    using common_value_t = std::conditional_t<
+        is_complex<a>::value || is_complex<b>::value,
+        complex_t<decltype(typename real_type<a>::type{} + typename real_type<b>::type{})>,
+        decltype(typename real_type<a>::type{} + typename real_type<b>::type{})>;
+    
+    /// 标量类型转换，支持复数之间、实数到复数的转换
+    template<Scalar target_t, Scalar t>
+    constexpr target_t convert(t const &x) {
+        if constexpr (is_complex<target_t>::value && is_complex<t>::value)
+            return {x.re, x.im};
+        else
+            return static_cast<target_t>(x);
+    }
+    
+    /// 信号表达式：惰性求值的逐点运算，由 lazy 引入
+    template<class t>
+    concept SignalExpression = requires(t const &e, size_t i) {
+        typename t::value_t;
+        typename t::frequency_t;
+        typename t::time_t;
+        e.sampling_frequency;
+        e.begin_time;
+        { e.size() } -> std::convertible_to<size_t>;
+        e.at(i);
+        e.is_expression;
+    };
+    
+    /// 可以参与逐点运算的信号或信号表达式
+    template<class t>
+    concept SignalOperand = Signal<std::remove_cvref_t<t>> || SignalExpression<std::remove_cvref_t<t>>;
+    
+    /// 取信号或表达式的长度
+    template<class t>
+    size_t size_of(t const &x) {
+        if constexpr (SignalExpression<t>)
+            return x.size();
+        else
+            return x.values.size();
+    }
+    
+    /// 取信号或表达式的第 i 个值
+    template<class t>
+    auto value_at(t const &x, size_t i) {
+        if constexpr (SignalExpression<t>)
+            return x.at(i);
+        else
+            return x.values[i];
+    }
+    
+    /// 表达式中保存操作数的方式：左值保存引用，右值移入表达式
+    /// 因此表达式只能移动、不能复制，应在引用的信号仍然存在时求值，不要从函数中返回
+    template<class t>
+    using operand_storage_t = std::conditional_t<std::is_lvalue_reference_v<t>, t, std::remove_cvref_t<t>>;
+    
+    /// 惰性求值的信号，作为表达式的叶子
+    /// \tparam s_t 信号类型
+    template<class s_t>
+    struct lazy_signal_t {
+        using s_type = std::remove_cvref_t<s_t>;
+        using value_t = typename s_type::value_t;
+        using frequency_t = typename s_type::frequency_t;
+        using time_t = typename s_type::time_t;
+        constexpr static bool is_expression = true;
+        
+        operand_storage_t<s_t> s;
+        frequency_t sampling_frequency;
+        time_t begin_time;
+        
+        explicit lazy_signal_t(s_t &&_s)
+            : s(std::forward<s_t>(_s)),
+              sampling_frequency(s.sampling_frequency),
+              begin_time(s.begin_time) {}
+        
+        lazy_signal_t(lazy_signal_t const &) = delete;
+        
+        lazy_signal_t(lazy_signal_t &&) = default;
+        
+        [[nodiscard]] size_t size() const { return s.values.size(); }
+        
+        [[nodiscard]] value_t at(size_t i) const { return s.values[i]; }
+        
+        operator signal_t<value_t, frequency_t, time_t>() const { return evaluate(*this); }
+    };
+    
+    /// 以信号开始一条惰性求值的表达式：lazy(a) + b * c 在赋给信号时一次循环完成，不产生中间信号
+    /// 不用 lazy 时每个运算符立即求值，返回信号
+    /// \tparam s_t 信号类型
+    /// \param s 信号，左值保存引用，右值移入表达式
+    /// \return 表达式
+    template<class s_t> requires Signal<std::remove_cvref_t<s_t>>
+    [[nodiscard]] auto lazy(s_t &&s) {
+        return lazy_signal_t<s_t>(std::forward<s_t>(s));
+    }
+    
+    /// 两个信号的逐点运算
+    /// 按起始时间对齐，结果覆盖两信号的时间范围；
+    /// 与原先逐个复制的语义一致：先放入 a，再在 b 的范围内与 b 运算，b 范围外保持 a（或 0）
+    /// \tparam op_t 运算
+    /// \tparam a_t 操作数 a 的类型
+    /// \tparam b_t 操作数 b 的类型
+    template<class op_t, class a_t, class b_t>
+    struct binary_expression_t {
+        using a_type = std::remove_cvref_t<a_t>;
+        using b_type = std::remove_cvref_t<b_t>;
+        using value_t = common_value_t<typename a_type::value_t, typename b_type::value_t>;
+        using frequency_t = same_or<typename a_type::frequency_t, typename b_type::frequency_t, Hz_t>;
+        using time_t = same_or<typename a_type::time_t, typename b_type::time_t, floating_seconds>;
+        constexpr static bool is_expression = true;
+        
+        operand_storage_t<a_t> a;
+        operand_storage_t<b_t> b;
+        frequency_t sampling_frequency;
+        time_t begin_time;
+        size_t ia, na, ib, nb, n;
+        bool aligned;
+        
+        binary_expression_t(binary_expression_t const &) = delete;
+        
+        binary_expression_t(binary_expression_t &&) = default;
+        
+        binary_expression_t(a_t &&_a, b_t &&_b)
+            : a(std::forward<a_t>(_a)), b(std::forward<b_t>(_b)) {
+            const auto fa = a.sampling_frequency.template cast_to<frequency_t>();
+            const auto fb = b.sampling_frequency.template cast_to<frequency_t>();
+            if (fa != fb) throw std::invalid_argument("the two signals should be with same sampling_frequency");
+            
+            const auto ta = std::chrono::duration_cast<time_t>(a.begin_time);
+            const auto tb = std::chrono::duration_cast<time_t>(b.begin_time);
+            sampling_frequency = fa;
+            begin_time = std::min(ta, tb);
+            ia = sampling_frequency.index_of(ta - begin_time);
+            ib = sampling_frequency.index_of(tb - begin_time);
+            na = size_of(a);
+            nb = size_of(b);
+            n = std::max(ia + na, ib + nb);
+            aligned = ia == 0 && ib == 0 && na == nb;
+        }
+        
+        [[nodiscard]] size_t size() const { return n; }
+        
+        [[nodiscard]] value_t at(size_t i) const {
+            // 两信号完全对齐时此分支与循环无关，可以被外提
+            if (aligned)
+                return op_t{}(convert<value_t>(value_at(a, i)), convert<value_t>(value_at(b, i)));
+            auto x = i >= ia && i < ia + na ? convert<value_t>(value_at(a, i - ia)) : value_t{};
+            return i >= ib && i < ib + nb ? op_t{}(x, convert<value_t>(value_at(b, i - ib))) : x;
+        }
+        
+        operator signal_t<value_t, frequency_t, time_t>() const { return evaluate(*this); }
+    };
+    
+    /// 信号与标量的逐点运算
+    /// \tparam op_t 运算
+    /// \tparam s_t 信号操作数类型
+    /// \tparam scalar_t 标量类型
+    /// \tparam scalar_first 标量是否为左操作数
+    template<class op_t, class s_t, Scalar scalar_t, bool scalar_first>
+    struct scalar_expression_t {
+        using s_type = std::remove_cvref_t<s_t>;
+        using value_t = common_value_t<typename s_type::value_t, scalar_t>;
+        using frequency_t = typename s_type::frequency_t;
+        using time_t = typename s_type::time_t;
+        constexpr static bool is_expression = true;
+        
+        operand_storage_t<s_t> s;
+        value_t k;
+        frequency_t sampling_frequency;
+        time_t begin_time;
+        
+        scalar_expression_t(scalar_expression_t const &) = delete;
+        
+        scalar_expression_t(scalar_expression_t &&) = default;
+        
+        scalar_expression_t(s_t &&_s, scalar_t _k)
+            : s(std::forward<s_t>(_s)),
+              k(convert<value_t>(_k)),
+              sampling_frequency(s.sampling_frequency),
+              begin_time(s.begin_time) {}
+        
+        [[nodiscard]] size_t size() const { return size_of(s); }
+        
+        [[nodiscard]] value_t at(size_t i) const {
+            if constexpr (scalar_first)
+                return op_t{}(k, convert<value_t>(value_at(s, i)));
+            else
+                return op_t{}(convert<value_t>(value_at(s, i)), k);
+        }
+        
+        operator signal_t<value_t, frequency_t, time_t>() const { return evaluate(*this); }
+    };
+    
+    /// 对表达式求值，在一次循环中完成全部运算
+    /// \tparam expression_t 表达式类型
+    /// \param e 表达式
+    /// \return 信号
+    template<SignalExpression expression_t>
+    auto evaluate(expression_t const &e) {
+        using result_t = signal_t<typename expression_t::value_t, typename expression_t::frequency_t, typename expression_t::time_t>;
+        const auto n = e.size();
+        auto result = result_t{
+            .values = std::vector<typename expression_t::value_t>(n),
+            .sampling_frequency = e.sampling_frequency,
+            .begin_time = e.begin_time,
+        };
+        auto *p = result.values.data();
+        for (size_t i = 0; i < n; ++i) p[i] = e.at(i);
+        return result;
+    }
+    
+    /// 从表达式构造信号：signal_t x = lazy(a) + b;
+    template<SignalExpression expression_t>
+    signal_t(expression_t) -> signal_t<typename expression_t::value_t, typename expression_t::frequency_t, typename expression_t::time_t>;
+    
+    /// 操作数中有表达式（由 lazy 引入）时继续构造表达式，否则立即求值为信号
+    template<class... operands_t, class expression_t>
+    auto evaluate_unless_lazy(expression_t &&e) {
+        if constexpr ((SignalExpression<std::remove_cvref_t<operands_t>> || ...))
+            return std::forward<expression_t>(e);
+        else
+            return evaluate(e);
+    }
+    
+    #define OPERATOR(WHAT, OP)                                                                                                \
+    template<SignalOperand a_t, SignalOperand b_t>                                                                            \
+    auto operator WHAT(a_t &&a, b_t &&b) {                                                                                    \
+        return evaluate_unless_lazy<a_t, b_t>(binary_expression_t<OP, a_t, b_t>(std::forward<a_t>(a), std::forward<b_t>(b))); \
+    }                                                                                                                         \
+                                                                                                                              \
+    template<SignalOperand a_t, Scalar scalar_t>                                                                              \
+    auto operator WHAT(a_t &&a, scalar_t k) {                                                                                 \
+        return evaluate_unless_lazy<a_t>(scalar_expression_t<OP, a_t, scalar_t, false>(std::forward<a_t>(a), k));             \
+    }                                                                                                                         \
+                                                                                                                              \
+    template<Scalar scalar_t, SignalOperand b_t>                                                                              \
+    auto operator WHAT(scalar_t k, b_t &&b) {                                                                                 \
+        return evaluate_unless_lazy<b_t>(scalar_expression_t<OP, b_t, scalar_t, true>(std::forward<b_t>(b), k));              \
+    }
+    
+    OPERATOR(+, std::plus<>)
+    
+    OPERATOR(-, std::minus<>)
+    
+    OPERATOR(*, std::multiplies<>)
+    
+    #undef OPERATOR
+}
+
+#endif // DSP_SIMULATION_SIGNAL_EXPRESSION_H
@@ -0,0 +1,223 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SIGNAL_RING_H
+#define DSP_SIMULATION_SIGNAL_RING_H
+
+#include <cmath>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "fft.h"
+
+namespace mechdancer {
+    /// 单生产者单消费者的无锁环形缓冲信号源
+    /// 生产者追加采集到的数据块，消费者按固定长度、固定步进取窗，窗可以重叠。
+    /// 采样按绝对序号计数，每个窗的起始时间由序号以双精度换算，不随分块累积误差；
+    /// time_t 为单精度（如 floating_seconds）时时刻本身只有约 7 位有效数字，长时间的数据流应使用双精度或整数计数的时间类型
+    /// \tparam t 数值类型
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    template<class t, Frequency frequency_t, Time time_t>
+    class signal_ring_t {
+        std::vector<t> _buffer;
+        size_t _mask;
+        frequency_t _fs;
+        time_t _origin;
+        
+        // 生产者、消费者各自修改的计数放在不同的缓存行上
+        alignas(64) std::atomic<uint64_t> _written{0};
+        alignas(64) std::atomic<uint64_t> _read{0};
+        
+        [[nodiscard]] double hz() const {
+            using ratio = typename frequency_t::ratio;
+            return static_cast<double>(_fs.value) * ratio::num / ratio::den;
+        }
+    
+    public:
+        using window_t = signal_t<t, frequency_t, time_t>;
+        
+        /// 构造环形缓冲
+        /// \param capacity 容量，向上取到 2 的幂
+        /// \param sampling_frequency 采样频率
+        /// \param origin 第 0 个采样的时刻
+        signal_ring_t(size_t capacity, frequency_t sampling_frequency, time_t origin)
+            : _buffer(enlarge_to_2_power(std::max<size_t>(capacity, 4))),
+              _mask(_buffer.size() - 1),
+              _fs(sampling_frequency),
+              _origin(origin) {}
+        
+        [[nodiscard]] size_t capacity() const { return _buffer.size(); }
+        
+        [[nodiscard]] frequency_t sampling_frequency() const { return _fs; }
+        
+        /// 第 index 个采样的时刻，以双精度计算
+        [[nodiscard]] time_t time_of(uint64_t index) const {
+            return _origin + std::chrono::duration_cast<time_t>(std::chrono::duration<double>(static_cast<double>(index) / hz()));
+        }
+        
+        /// 时刻 time 对应的采样序号（四舍五入），以双精度计算
+        template<Time _time_t>
+        [[nodiscard]] int64_t index_of(_time_t time) const {
+            const auto offset = std::chrono::duration<double>(time) - std::chrono::duration<double>(_origin);
+            return std::llround(offset.count() * hz());
+        }
+        
+        /// 已写入的采样总数
+        [[nodiscard]] uint64_t written() const { return _written.load(std::memory_order_acquire); }
+        
+        /// 已被消费（窗已越过）的采样总数
+        [[nodiscard]] uint64_t consumed() const { return _read.load(std::memory_order_acquire); }
+        
+        /// 可以读取的采样数
+        [[nodiscard]] size_t available() const {
+            return static_cast<size_t>(written() - consumed());
+        }
+        
+        /// 生产者：追加采样，空间不足时只写入能容纳的部分
+        /// \param data 数据
+        /// \param n 数量
+        /// \return 实际写入的数量
+        size_t push(t const *data, size_t n) {
+            const auto head = _written.load(std::memory_order_relaxed);
+            const auto tail = _read.load(std::memory_order_acquire);
+            n = std::min(n, _buffer.size() - static_cast<size_t>(head - tail));
+            const auto begin = static_cast<size_t>(head & _mask);
+            const auto first = std::min(n, _buffer.size() - begin);
+            std::copy_n(data, first, _buffer.data() + begin);
+            std::copy_n(data + first, n - first, _buffer.data());
+            _written.store(head + n, std::memory_order_release);
+            return n;
+        }
+        
+        /// 生产者：追加一个数据块
+        /// 块的起始时间必须与已写入数据的末尾衔接，即换算为采样序号后等于已写入的采样数
+        /// \tparam _signal_t 信号类型
+        /// \param block 数据块
+        /// \return 实际写入的数量
+        template<Signal _signal_t>
+        size_t push(_signal_t const &block) {
+            const auto head = _written.load(std::memory_order_relaxed);
+            if (index_of(block.begin_time) != static_cast<int64_t>(head))
+                throw std::invalid_argument("the block is not contiguous with the stream");
+            auto const *data = std::data(block.values);
+            return push(data, block.values.size());
+        }
+        
+        /// 消费者：取一个窗并前进
+        /// \param window 输出窗，复用其存储
+        /// \param size 窗长
+        /// \param hop 步进，小于窗长时相邻窗重叠 size - hop 个采样
+        /// \return 数据不足一个窗时返回 false，不前进
+        bool read(window_t &window, size_t size, size_t hop) {
+            if (size > _buffer.size()) throw std::invalid_argument("window is larger than the ring");
+            if (hop == 0 || hop > size) throw std::invalid_argument("hop should be in [1, size]");
+            const auto tail = _read.load(std::memory_order_relaxed);
+            const auto head = _written.load(std::memory_order_acquire);
+            if (head - tail < size) return false;
+            window.values.resize(size);
+            const auto begin = static_cast<size_t>(tail & _mask);
+            const auto first = std::min(size, _buffer.size() - begin);
+            std::copy_n(_buffer.data() + begin, first, window.values.data());
+            std::copy_n(_buffer.data(), size - first, window.values.data() + first);
+            window.sampling_frequency = _fs;
+            window.begin_time = time_of(tail);
+            _read.store(tail + hop, std::memory_order_release);
+            return true;
+        }
+        
+        /// 消费者：反复取窗处理，直到数据不足
+        /// \tparam fun_t 处理函数类型
+        /// \param size 窗长
+        /// \param hop 步进
+        /// \param fun 处理函数，参数为窗
+        /// \return 处理的窗数
+        template<class fun_t>
+        size_t for_each_window(size_t size, size_t hop, fun_t fun) {
+            window_t window{.values = {}, .sampling_frequency = _fs, .begin_time = _origin};
+            size_t count = 0;
+            for (; read(window, size, hop); ++count) fun(window);
+            return count;
+        }
+    };
+    
+    /// 重叠保留法 FIR 滤波，可以接在环形缓冲后处理连续的数据流
+    /// 每个窗长 N，步进 N - M + 1（M 为滤波器长度），每窗输出 N - M + 1 个有效采样，
+    /// 各窗的输出首尾相接，等于整个数据流与滤波器的线性卷积（第一个窗之前的 M - 1 个输出除外，
+    /// 需要时可以先向环形缓冲写入 M - 1 个 0，并把起点提前相应时间）
+    /// \tparam t 数值类型
+    template<Floating t = float>
+    class overlap_save_t {
+        std::vector<complex_t<t>> _spectrum, _memory;
+        size_t _taps;
+        floating_seconds _delay;
+    
+    public:
+        /// 构造
+        /// \tparam _signal_t 实信号类型
+        /// \param kernel 滤波器冲激响应，其起始时间计入输出时刻
+        /// \param size 窗长，向上取到 2 的幂，必须大于滤波器长度
+        template<RealSignal _signal_t>
+        overlap_save_t(_signal_t const &kernel, size_t size)
+            : _spectrum(enlarge_to_2_power(std::max<size_t>(size, 4))),
+              _taps(kernel.values.size()),
+              _delay(kernel.begin_time) {
+            if (_taps == 0 || _taps >= _spectrum.size())
+                throw std::invalid_argument("window should be longer than the kernel");
+            std::transform(kernel.values.begin(), kernel.values.end(), _spectrum.begin(),
+                           [](auto x) { return complex_t<t>(static_cast<t>(x)); });
+            fft(_spectrum);
+        }
+        
+        /// 窗长
+        [[nodiscard]] size_t size() const { return _spectrum.size(); }
+        
+        /// 相邻窗的步进
+        [[nodiscard]] size_t hop() const { return _spectrum.size() - _taps + 1; }
+        
+        /// 处理一个窗
+        /// \tparam _signal_t 实信号类型
+        /// \param window 长度为 size() 的窗
+        /// \return 有效输出，起始时间为窗起始时间加 M - 1 个采样再加滤波器起始时间
+        template<RealSignal _signal_t>
+        auto operator()(_signal_t const &window) {
+            using time_t = typename _signal_t::time_t;
+            using result_t = signal_t<t, typename _signal_t::frequency_t, time_t>;
+            
+            const auto n = _spectrum.size();
+            if (window.values.size() != n) throw std::invalid_argument("window size mismatch");
+            _memory.resize(n);
+            std::transform(window.values.begin(), window.values.end(), _memory.begin(),
+                           [](auto x) { return complex_t<t>(static_cast<t>(x)); });
+            fft(_memory);
+            for (size_t i = 0; i < n; ++i) _memory[i] *= _spectrum[i];
+            ifft(_memory);
+            auto result = result_t{
+                .values = std::vector<t>(hop()),
+                .sampling_frequency = window.sampling_frequency,
+                .begin_time = window.begin_time
+                              + window.sampling_frequency.template duration_of<time_t>(_taps - 1)
+                              + std::chrono::duration_cast<time_t>(_delay),
+            };
+            std::transform(_memory.begin() + (_taps - 1), _memory.end(), result.values.begin(), [](auto z) { return z.re; });
+            return result;
+        }
+        
+        /// 处理环形缓冲中所有完整的窗
+        /// \tparam ring_t 环形缓冲类型
+        /// \tparam sink_t 输出处理函数类型
+        /// \param ring 环形缓冲
+        /// \param sink 输出处理函数，参数为每窗的有效输出
+        /// \return 处理的窗数
+        template<class ring_t, class sink_t>
+        size_t operator()(ring_t &ring, sink_t sink) {
+            return ring.for_each_window(size(), hop(), [&](auto const &window) { sink((*this)(window)); });
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_SIGNAL_RING_H
@@ -0,0 +1,510 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SIGNAL_STREAM_H
+#define DSP_SIMULATION_SIGNAL_STREAM_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <condition_variable>
+
+#include "signal_ring.h"
+#include "text_loader.h"
+#include "../types/packed12_t.hpp"
+
+namespace mechdancer {
+    /// 解码器读出的一段采样
+    template<class t>
+    struct stream_chunk_t {
+        std::vector<t> values;
+        std::vector<size_t> marks; // 段内的帧起点，升序
+    };
+    
+    /// 以空白分隔的数值文本文件的解码器，按块读入，不受文件大小限制
+    /// \tparam t 数值类型
+    template<class t = float>
+    class text_decoder_t {
+        std::ifstream _file;
+        std::string _text;
+        size_t _chunk;
+        bool _end = false;
+    
+    public:
+        using value_t = t;
+        
+        /// 打开文件，失败时抛出 std::runtime_error
+        /// \param path 文件路径
+        /// \param chunk 每次读入的字节数
+        explicit text_decoder_t(std::string const &path, size_t chunk = size_t{1} << 20)
+            : _file(path, std::ios_base::binary), _chunk(std::max<size_t>(chunk, 64)) {
+            if (!_file) throw std::runtime_error("failed to open " + path);
+        }
+        
+        /// 读出一段，遇到无法解析的内容即结束
+        /// \return 是否读到数据
+        bool read(stream_chunk_t<t> &chunk) {
+            chunk.values.clear();
+            chunk.marks.clear();
+            while (chunk.values.empty() && !_end) {
+                const auto used = _text.size();
+                _text.resize(used + _chunk);
+                _file.read(_text.data() + used, static_cast<std::streamsize>(_chunk));
+                _text.resize(used + static_cast<size_t>(_file.gcount()));
+                // 最后一个空白之后的内容可能是半个数，留到下一块
+                auto end = _file ? _text.find_last_of(" \t\n\r\v\f") : _text.size();
+                if (end == std::string::npos) continue;
+                if (!parse_numbers(std::string_view(_text).substr(0, end), chunk.values) || !_file) _end = true;
+                _text.erase(0, end);
+            }
+            return !chunk.values.empty();
+        }
+    };
+    
+    /// 原始二进制采样文件的解码器
+    /// \tparam t 采样类型
+    template<class t>
+    class binary_decoder_t {
+        std::ifstream _file;
+        size_t _chunk;
+    
+    public:
+        using value_t = t;
+        
+        /// 打开文件，失败时抛出 std::runtime_error
+        /// \param path 文件路径
+        /// \param offset 跳过的文件头字节数
+        /// \param chunk 每次读入的采样数
+        explicit binary_decoder_t(std::string const &path, size_t offset = 0, size_t chunk = size_t{1} << 20)
+            : _file(path, std::ios_base::binary), _chunk(std::max<size_t>(chunk, 1)) {
+            if (!_file) throw std::runtime_error("failed to open " + path);
+            _file.seekg(static_cast<std::streamoff>(offset));
+        }
+        
+        bool read(stream_chunk_t<t> &chunk) {
+            chunk.marks.clear();
+            chunk.values.resize(_chunk);
+            _file.read(reinterpret_cast<char *>(chunk.values.data()), static_cast<std::streamsize>(_chunk * sizeof(t)));
+            chunk.values.resize(static_cast<size_t>(_file.gcount()) / sizeof(t));
+            return !chunk.values.empty();
+        }
+    };
+    
+    /// 带帧标记的 16 位采集文件的解码器
+    /// 大于 4096 的值标记一帧的起点，读出的采样值去掉标记
+    class capture_decoder_t {
+        binary_decoder_t<uint16_t> _file;
+    
+    public:
+        using value_t = uint16_t;
+        
+        explicit capture_decoder_t(std::string const &path, size_t chunk = size_t{1} << 20)
+            : _file(path, 0, chunk) {}
+        
+        bool read(stream_chunk_t<uint16_t> &chunk) {
+            if (!_file.read(chunk)) return false;
+            for (size_t i = 0; i < chunk.values.size(); ++i)
+                if (chunk.values[i] > packed12_frames_t::MARKER) {
+                    chunk.marks.push_back(i);
+                    chunk.values[i] -= packed12_frames_t::MARKER;
+                }
+            return true;
+        }
+    };
+    
+    /// 12 位紧凑存储文件的解码器，
+    /// 读取 packed12_vector_t::write 或 packed12_frames_t::write 写出的文件
+    class packed12_decoder_t {
+        std::ifstream _file;
+        std::vector<uint8_t> _bytes;
+        std::vector<uint64_t> _frames;
+        uint64_t _remain = 0, _index = 0;
+        size_t _next_frame = 0;
+        
+        uint64_t get() {
+            uint8_t bytes[8];
+            if (!_file.read(reinterpret_cast<char *>(bytes), sizeof bytes))
+                throw std::runtime_error("failed to read packed samples");
+            uint64_t x = 0;
+            for (int i = 0; i < 8; ++i) x |= static_cast<uint64_t>(bytes[i]) << 8 * i;
+            return x;
+        }
+    
+    public:
+        using value_t = uint16_t;
+        
+        /// 打开文件，失败时抛出 std::runtime_error
+        /// \param path 文件路径
+        /// \param framed 是否为 packed12_frames_t 的文件（带帧起点）
+        /// \param chunk 每次读入的采样数，取偶数
+        explicit packed12_decoder_t(std::string const &path, bool framed = false, size_t chunk = size_t{1} << 20)
+            : _file(path, std::ios_base::binary), _bytes((std::max<size_t>(chunk, 2) + 1) / 2 * 3) {
+            if (!_file) throw std::runtime_error("failed to open " + path);
+            if (framed) {
+                _frames.resize(static_cast<size_t>(get()));
+                for (auto &x : _frames) x = get();
+            }
+            _remain = get();
+        }
+        
+        bool read(stream_chunk_t<uint16_t> &chunk) {
+            chunk.marks.clear();
+            const auto n = static_cast<size_t>(std::min<uint64_t>(_remain, _bytes.size() / 3 * 2));
+            chunk.values.resize(n);
+            if (n == 0) return false;
+            const auto bytes = (n + 1) / 2 * 3;
+            if (!_file.read(reinterpret_cast<char *>(_bytes.data()), static_cast<std::streamsize>(bytes)))
+                throw std::runtime_error("packed samples are truncated");
+            auto const *p = _bytes.data();
+            for (size_t j = 0; j < n / 2; ++j) {
+                chunk.values[2 * j] = static_cast<uint16_t>(p[3 * j] | (p[3 * j + 1] & 0x0f) << 8);
+                chunk.values[2 * j + 1] = static_cast<uint16_t>(p[3 * j + 1] >> 4 | p[3 * j + 2] << 4);
+            }
+            if (n % 2) chunk.values[n - 1] = static_cast<uint16_t>(p[3 * (n / 2)] | (p[3 * (n / 2) + 1] & 0x0f) << 8);
+            for (; _next_frame < _frames.size() && _frames[_next_frame] < _index + n; ++_next_frame)
+                chunk.marks.push_back(static_cast<size_t>(_frames[_next_frame] - _index));
+            _index += n;
+            _remain -= n;
+            return true;
+        }
+    };
+    
+    /// 分块流式信号源
+    /// 后台线程用解码器预读文件，最多缓存 depth 段，内存占用与文件大小无关；
+    /// 消费者按固定长度、固定步进取窗，或按帧标记取帧。
+    /// 采样按绝对序号计数，每块的起始时间由序号以双精度换算，不随分块累积误差；
+    /// time_t 为单精度（如 floating_seconds）时 begin_time 只有约 7 位有效数字，
+    /// 需要精确到采样时用 block_index 取块首采样的绝对序号，或使用双精度、整数计数的时间类型。
+    /// 取窗的接口与 signal_ring_t 相同，overlap_save_t 可以直接处理；
+    /// 同一个流只能按一种方式读取
+    /// \tparam decoder_t 解码器类型
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    template<class decoder_t, Frequency frequency_t, Time time_t>
+    class signal_stream_t {
+    public:
+        using value_t = typename decoder_t::value_t;
+        using block_t = signal_t<value_t, frequency_t, time_t>;
+    
+    private:
+        using chunk_t = stream_chunk_t<value_t>;
+        
+        decoder_t _decoder;
+        frequency_t _fs;
+        time_t _origin;
+        size_t _depth;
+        
+        std::deque<chunk_t> _queue;
+        bool _end = false, _stop = false;
+        std::exception_ptr _error;
+        std::mutex _mutex;
+        std::condition_variable _ready, _space;
+        
+        // 消费者状态
+        chunk_t _chunk;
+        size_t _position = 0, _mark = 0;
+        uint64_t _index = 0;               // _chunk.values[_position] 的绝对序号
+        std::vector<value_t> _pending;     // 取窗：从 _pending_index 开始的未丢弃采样
+        uint64_t _pending_index = 0;
+        uint64_t _block_index = 0;         // 最近取出的块的首个采样的绝对序号
+        size_t _covered = 0;               // _pending 开头已在上一窗中出现的采样数
+        bool _drained = false;
+        
+        std::thread _thread;
+        
+        void run() {
+            try {
+                while (true) {
+                    chunk_t chunk;
+                    if (!_decoder.read(chunk)) break;
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _space.wait(lock, [this] { return _stop || _queue.size() < _depth; });
+                    if (_stop) return;
+                    _queue.push_back(std::move(chunk));
+                    lock.unlock();
+                    _ready.notify_one();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> _(_mutex);
+                _error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> _(_mutex);
+                _end = true;
+            }
+            _ready.notify_one();
+        }
+        
+        /// 取下一段，没有更多数据时返回 false，解码出错时抛出其异常
+        bool next_chunk() {
+            _index += _chunk.values.size() - _position;
+            std::unique_lock<std::mutex> lock(_mutex);
+            _ready.wait(lock, [this] { return !_queue.empty() || _end; });
+            if (_queue.empty()) {
+                if (_error) std::rethrow_exception(std::exchange(_error, nullptr));
+                return false;
+            }
+            _chunk = std::move(_queue.front());
+            _queue.pop_front();
+            lock.unlock();
+            _space.notify_one();
+            _position = _mark = 0;
+            return true;
+        }
+        
+        /// 当前段已读完时取下一段
+        bool ensure() {
+            while (_position == _chunk.values.size())
+                if (!next_chunk()) return false;
+            return true;
+        }
+    
+    public:
+        /// 开始预读
+        /// \param decoder 解码器
+        /// \param sampling_frequency 采样频率
+        /// \param origin 第 0 个采样的时刻
+        /// \param depth 最多预读的段数
+        signal_stream_t(decoder_t decoder, frequency_t sampling_frequency, time_t origin, size_t depth = 4)
+            : _decoder(std::move(decoder)),
+              _fs(sampling_frequency),
+              _origin(origin),
+              _depth(std::max<size_t>(depth, 1)),
+              _thread([this] { run(); }) {}
+        
+        signal_stream_t(signal_stream_t const &) = delete;
+        
+        signal_stream_t &operator=(signal_stream_t const &) = delete;
+        
+        ~signal_stream_t() {
+            {
+                std::lock_guard<std::mutex> _(_mutex);
+                _stop = true;
+            }
+            _space.notify_one();
+            _thread.join();
+        }
+        
+        [[nodiscard]] frequency_t sampling_frequency() const { return _fs; }
+        
+        /// 第 index 个采样的时刻，以双精度计算，time_t 的精度足够时长时间的记录也精确到采样
+        [[nodiscard]] time_t time_of(uint64_t index) const {
+            using ratio = typename frequency_t::ratio;
+            const auto hz = static_cast<double>(_fs.value) * ratio::num / ratio::den;
+            return _origin + std::chrono::duration_cast<time_t>(std::chrono::duration<double>(static_cast<double>(index) / hz));
+        }
+        
+        /// 最近一次取出的窗或帧的首个采样的绝对序号
+        [[nodiscard]] uint64_t block_index() const { return _block_index; }
+        
+        /// 取一个窗并前进
+        /// 最后不足一窗的数据补 0 成一窗，之后返回 false
+        /// \param window 输出窗，复用其存储
+        /// \param size 窗长
+        /// \param hop 步进，小于窗长时相邻窗重叠 size - hop 个采样
+        /// \return 没有新的数据时返回 false
+        bool read(block_t &window, size_t size, size_t hop) {
+            if (hop == 0 || hop > size) throw std::invalid_argument("hop should be in [1, size]");
+            while (_pending.size() < size && ensure()) {
+                const auto n = std::min(size - _pending.size(), _chunk.values.size() - _position);
+                _pending.insert(_pending.end(), _chunk.values.begin() + _position, _chunk.values.begin() + _position + n);
+                _position += n;
+            }
+            if (_pending.size() <= _covered || _drained) {
+                _drained = true;
+                return false;
+            }
+            window.values.assign(_pending.begin(), _pending.end());
+            if (window.values.size() < size) {
+                window.values.resize(size, value_t{});
+                _drained = true;
+            }
+            window.sampling_frequency = _fs;
+            window.begin_time = time_of(_pending_index);
+            _block_index = _pending_index;
+            _pending.erase(_pending.begin(), _pending.begin() + std::min(hop, _pending.size()));
+            _pending_index += hop;
+            _covered = size - hop;
+            return true;
+        }
+        
+        /// 取下一帧，帧从一个帧标记开始，到下一个帧标记为止，第一个帧标记之前的采样丢弃
+        /// \param frame 输出帧，复用其存储
+        /// \param limit 最多保留的采样数，超出的部分丢弃
+        /// \return 没有更多帧时返回 false
+        bool read_frame(block_t &frame, size_t limit = -1) {
+            // 跳到下一个帧标记
+            while (true) {
+                if (!ensure()) return false;
+                while (_mark < _chunk.marks.size() && _chunk.marks[_mark] < _position) ++_mark;
+                if (_mark < _chunk.marks.size()) break;
+                _index += _chunk.values.size() - _position;
+                _position = _chunk.values.size();
+            }
+            _index += _chunk.marks[_mark] - _position;
+            _position = _chunk.marks[_mark++];
+            frame.values.clear();
+            frame.sampling_frequency = _fs;
+            frame.begin_time = time_of(_index);
+            _block_index = _index;
+            // 收集到下一个帧标记或文件末尾
+            while (ensure()) {
+                const auto end = _mark < _chunk.marks.size() ? _chunk.marks[_mark] : _chunk.values.size();
+                const auto n = std::min(end - _position, limit - std::min(limit, frame.values.size()));
+                frame.values.insert(frame.values.end(), _chunk.values.begin() + _position, _chunk.values.begin() + _position + n);
+                _index += end - _position;
+                _position = end;
+                if (_mark < _chunk.marks.size()) break;
+            }
+            return true;
+        }
+        
+        /// 反复取窗处理，直到数据读完
+        /// \tparam fun_t 处理函数类型
+        /// \param size 窗长
+        /// \param hop 步进
+        /// \param fun 处理函数，参数为窗
+        /// \return 处理的窗数
+        template<class fun_t>
+        size_t for_each_window(size_t size, size_t hop, fun_t fun) {
+            block_t window{.values = {}, .sampling_frequency = _fs, .begin_time = _origin};
+            size_t count = 0;
+            for (; read(window, size, hop); ++count) fun(window);
+            return count;
+        }
+        
+        /// 按顺序处理每一帧
+        /// \tparam fun_t 处理函数类型
+        /// \param fun 处理函数，参数为帧序号和帧
+        /// \param limit 每帧最多保留的采样数
+        /// \return 帧数
+        template<class fun_t>
+        size_t for_each_frame(fun_t fun, size_t limit = -1) {
+            block_t frame{.values = {}, .sampling_frequency = _fs, .begin_time = _origin};
+            size_t i = 0;
+            for (; read_frame(frame, limit); ++i) fun(i, frame);
+            return i;
+        }
+        
+        /// 块的输入范围，迭代器解引用得到当前块
+        class range_t {
+            signal_stream_t *_stream;
+            size_t _size, _hop;
+            bool _frames;
+            block_t _block;
+            bool _valid = false;
+            
+            void advance() {
+                _valid = _frames ? _stream->read_frame(_block, _size) : _stream->read(_block, _size, _hop);
+            }
+        
+        public:
+            range_t(signal_stream_t *stream, size_t size, size_t hop, bool frames)
+                : _stream(stream), _size(size), _hop(hop), _frames(frames),
+                  _block{.values = {}, .sampling_frequency = stream->_fs, .begin_time = stream->_origin} {}
+            
+            class iterator {
+                range_t *_range = nullptr;
+            
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = block_t;
+                using difference_type = std::ptrdiff_t;
+                using reference = block_t const &;
+                using pointer = block_t const *;
+                
+                iterator() = default;
+                
+                explicit iterator(range_t *range) : _range(range) {}
+                
+                reference operator*() const { return _range->_block; }
+                
+                pointer operator->() const { return &_range->_block; }
+                
+                iterator &operator++() {
+                    _range->advance();
+                    return *this;
+                }
+                
+                void operator++(int) { ++*this; }
+                
+                bool operator==(std::default_sentinel_t) const { return !_range->_valid; }
+            };
+            
+            iterator begin() {
+                advance();
+                return iterator(this);
+            }
+            
+            std::default_sentinel_t end() const { return {}; }
+        };
+        
+        /// 按固定长度、步进取窗的范围
+        range_t windows(size_t size, size_t hop) { return range_t(this, size, hop, false); }
+        
+        /// 按帧标记取帧的范围
+        range_t frames(size_t limit = -1) { return range_t(this, limit, 0, true); }
+    };
+    
+    /// 流式互相关使用的重叠保留滤波器，冲激响应为时间反转的参考信号
+    /// 输出第 k 个采样是参考信号首个采样对齐数据流第 k 个采样时的互相关值，
+    /// 其时刻为数据流中参考信号出现的起始时刻，即数据流第 k 个采样的时刻减去参考信号的起始时间
+    /// \tparam t 数值类型
+    /// \tparam _signal_t 参考信号类型
+    /// \param ref 参考信号
+    /// \param size 窗长，必须大于参考信号长度
+    template<Floating t = float, RealSignal _signal_t>
+    overlap_save_t<t> correlation_filter(_signal_t const &ref, size_t size) {
+        using namespace std::chrono;
+        auto kernel = signal_t<t, typename _signal_t::frequency_t, floating_seconds>{
+            .values = std::vector<t>(ref.values.size()),
+            .sampling_frequency = ref.sampling_frequency,
+            .begin_time = -ref.sampling_frequency.template duration_of<floating_seconds>(ref.values.size() - 1)
+                          - duration_cast<floating_seconds>(ref.begin_time),
+        };
+        std::transform(ref.values.rbegin(), ref.values.rend(), kernel.values.begin(), [](auto x) { return static_cast<t>(x); });
+        return overlap_save_t<t>(kernel, size);
+    }
+    
+    /// 跨块搜索最大值，可以作为 overlap_save_t 等流式处理的输出处理函数
+    /// \tparam value_t 数值类型
+    /// \tparam time_t 时间类型
+    template<class value_t, Time time_t>
+    struct peak_tracker_t {
+        std::optional<value_t> value; // 未见到任何采样时为空
+        time_t time{};
+        
+        template<RealSignal _signal_t>
+        void operator()(_signal_t const &block) {
+            auto const &values = block.values;
+            if (values.empty()) return;
+            auto max = std::max_element(values.begin(), values.end());
+            if (value && !(*max > *value)) return;
+            value = static_cast<value_t>(*max);
+            time = block.begin_time + block.sampling_frequency.template duration_of<time_t>(max - values.begin());
+        }
+    };
+    
+    /// 在块的范围中搜索最大值
+    /// \tparam range_t 块的范围类型
+    /// \param blocks 块
+    /// \return 最大值及其时刻
+    template<class range_t>
+    auto find_peak(range_t &&blocks) {
+        using block_t = std::remove_cvref_t<decltype(*std::begin(blocks))>;
+        peak_tracker_t<typename block_t::value_t, typename block_t::time_t> peak;
+        for (auto const &block : blocks) peak(block);
+        return peak;
+    }
+}
+
+#endif // DSP_SIMULATION_SIGNAL_STREAM_H
@@ -0,0 +1,57 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "signal_writer.hh"
+#include <utility>
+
+mechdancer::signal_writer_t::signal_writer_t()
+    : _thread([this] { run(); }) {}
+
+mechdancer::signal_writer_t::~signal_writer_t() {
+    {
+        std::lock_guard<std::mutex> _(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void mechdancer::signal_writer_t::submit(std::string path, job_t job) {
+    {
+        std::lock_guard<std::mutex> _(_mutex);
+        _jobs.emplace_back(std::move(path), std::move(job));
+    }
+    _wake.notify_one();
+}
+
+void mechdancer::signal_writer_t::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _jobs.empty() && _running == 0; });
+    if (_error) std::rethrow_exception(std::exchange(_error, nullptr));
+}
+
+void mechdancer::signal_writer_t::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [this] { return _stop || !_jobs.empty(); });
+        if (_jobs.empty()) return;
+        auto [path, job] = std::move(_jobs.front());
+        _jobs.pop_front();
+        ++_running;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            text_writer_t file(path);
+            job(file);
+            file.close();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        job = nullptr; // 在后台释放任务持有的数据
+        lock.lock();
+        if (error && !_error) _error = error;
+        --_running;
+        if (_jobs.empty()) _idle.notify_all();
+    }
+}
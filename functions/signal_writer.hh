@@ -0,0 +1,147 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SIGNAL_WRITER_HH
+#define DSP_SIMULATION_SIGNAL_WRITER_HH
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <condition_variable>
+
+namespace mechdancer {
+    /// 带大缓冲的文本输出
+    /// 数值用 std::to_chars 格式化，格式与 std::ostream 的默认格式相同（浮点数 6 位有效数字），
+    /// 缓冲满时整块写出；std::endl 只换行，不刷新。
+    /// 析构时写出剩余内容但不报告错误，需要确认写入成功时调用 close
+    class text_writer_t {
+        constexpr static size_t CAPACITY = size_t{1} << 20;
+        
+        std::string _path;
+        std::ofstream _file;
+        std::vector<char> _buffer;
+        size_t _used = 0;
+        
+        char *reserve(size_t n) {
+            if (_used + n > _buffer.size()) drain();
+            return _buffer.data() + _used;
+        }
+    
+    public:
+        /// 打开文件，失败时抛出 std::runtime_error
+        explicit text_writer_t(std::string const &path)
+            : _path(path), _file(path, std::ios_base::binary), _buffer(CAPACITY) {
+            if (!_file) throw std::runtime_error("failed to open " + path);
+        }
+        
+        text_writer_t(text_writer_t const &) = delete;
+        
+        text_writer_t &operator=(text_writer_t const &) = delete;
+        
+        ~text_writer_t() {
+            if (_file.is_open()) drain();
+        }
+        
+        /// 写出缓冲中的内容
+        void drain() {
+            _file.write(_buffer.data(), static_cast<std::streamsize>(_used));
+            _used = 0;
+        }
+        
+        /// 写出缓冲中的内容并关闭文件，写入失败时抛出 std::runtime_error
+        void close() {
+            drain();
+            _file.close();
+            if (!_file) throw std::runtime_error("failed to write " + _path);
+        }
+        
+        /// 写入原始字节
+        void write(void const *data, size_t size) {
+            *this << std::string_view(static_cast<char const *>(data), size);
+        }
+        
+        text_writer_t &operator<<(char c) {
+            *reserve(1) = c;
+            ++_used;
+            return *this;
+        }
+        
+        text_writer_t &operator<<(std::string_view text) {
+            if (text.size() > _buffer.size()) {
+                drain();
+                _file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            } else {
+                std::copy(text.begin(), text.end(), reserve(text.size()));
+                _used += text.size();
+            }
+            return *this;
+        }
+        
+        template<class t> requires std::is_arithmetic_v<t> && (!std::is_same_v<t, char>)
+        text_writer_t &operator<<(t value) {
+            constexpr static size_t MAX_LENGTH = 32;
+            auto *p = reserve(MAX_LENGTH);
+            std::to_chars_result result;
+            if constexpr (std::is_floating_point_v<t>)
+                result = std::to_chars(p, p + MAX_LENGTH, value, std::chars_format::general, 6);
+            else if constexpr (std::is_same_v<t, bool>)
+                result = std::to_chars(p, p + MAX_LENGTH, static_cast<int>(value));
+            else
+                result = std::to_chars(p, p + MAX_LENGTH, value);
+            _used += result.ptr - p;
+            return *this;
+        }
+        
+        /// 流操纵符，std::endl 换行，其他忽略
+        text_writer_t &operator<<(std::ostream &(*manipulator)(std::ostream &)) {
+            if (manipulator == static_cast<std::ostream &(*)(std::ostream &)>(std::endl)) *this << '\n';
+            return *this;
+        }
+    };
+    
+    /// 后台写文件服务
+    /// 写文件的任务在后台线程中按提交顺序执行，提交方不等待磁盘
+    class signal_writer_t {
+        using job_t = std::function<void(text_writer_t &)>;
+        
+        std::deque<std::pair<std::string, job_t>> _jobs;
+        size_t _running = 0;
+        bool _stop = false;
+        std::exception_ptr _error;
+        std::mutex _mutex;
+        std::condition_variable _wake, _idle;
+        std::thread _thread;
+        
+        void run();
+    
+    public:
+        signal_writer_t();
+        
+        signal_writer_t(signal_writer_t const &) = delete;
+        
+        signal_writer_t &operator=(signal_writer_t const &) = delete;
+        
+        /// 完成所有已提交的任务后退出
+        ~signal_writer_t();
+        
+        /// 提交任务
+        /// \param path 文件路径
+        /// \param job 写文件的函数，参数为已打开的输出
+        void submit(std::string path, job_t job);
+        
+        /// 等待已提交的任务全部完成，有任务失败时抛出其中第一个异常
+        void flush();
+    };
+}
+
+#endif // DSP_SIMULATION_SIGNAL_WRITER_HH
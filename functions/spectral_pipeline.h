@@ -0,0 +1,190 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SPECTRAL_PIPELINE_H
+#define DSP_SIMULATION_SPECTRAL_PIPELINE_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include "process_real.h"
+
+namespace mechdancer {
+    /// 频域处理流水线
+    /// 排队的频域操作（带通、白化、互相关、希尔伯特）在一次正变换和一次反变换之间依次完成
+    /// \tparam t 计算使用的数值类型
+    template<Floating t = float>
+    class spectral_pipeline_t {
+    public:
+        using spectrum_t = signal_t<complex_t<t>, Hz_t, floating_seconds>;
+    
+    private:
+        /// 频域操作，频谱采样频率为原信号采样频率
+        using stage_t = std::function<void(spectrum_t &)>;
+        
+        /// 参考信号及其不同长度下的频谱
+        struct reference_t {
+            std::vector<t> values;
+            floating_seconds begin_time;
+            std::map<size_t, std::vector<complex_t<t>>> spectrums;
+            std::mutex mutex;
+            
+            std::vector<complex_t<t>> const &spectrum(size_t size) {
+                std::lock_guard<std::mutex> _(mutex);
+                auto p = spectrums.find(size);
+                if (p != spectrums.end()) return p->second;
+                auto memory = std::vector<complex_t<t>>(size, complex_t<t>(values.back()));
+                std::transform(values.begin(), values.end(), memory.begin(), [](auto x) { return complex_t<t>(x); });
+                fft(memory);
+                return spectrums.emplace(size, std::move(memory)).first->second;
+            }
+        };
+        
+        std::vector<stage_t> _stages;
+        std::shared_ptr<reference_t> _reference;
+        Hz_t _reference_fs{};
+    
+    public:
+        /// 带通，保留 [min, max) 内的正负频率
+        /// \tparam f_t 频率类型
+        /// \param min 频率下限
+        /// \param max 频率上限
+        /// \return 流水线自身
+        template<Frequency f_t>
+        spectral_pipeline_t &bandpass(f_t min, f_t max) {
+            if (min >= max) throw std::invalid_argument("");
+            _stages.emplace_back([=](spectrum_t &spectrum) { mechdancer::bandpass(spectrum, min, max); });
+            return *this;
+        }
+        
+        /// 转为解析信号：去除负频率，正频率加倍，即希尔伯特变换后与原信号合为复信号
+        /// 注意 fft 的核为 e^{+jωn}，前一半对应负频率，后一半对应正频率
+        /// \return 流水线自身
+        spectral_pipeline_t &analytic() {
+            _stages.emplace_back([](spectrum_t &spectrum) {
+                auto &values = spectrum.values;
+                auto half = values.size() / 2;
+                std::fill(values.begin() + 1, values.begin() + half, complex_t<t>{});
+                for (auto i = half + 1; i < values.size(); ++i) values[i] *= 2;
+            });
+            return *this;
+        }
+        
+        /// 以参考信号做频域互相关（匹配滤波），输出第 0 点对应零时延
+        /// \tparam Tr 参考信号类型
+        /// \tparam fun_t 频点处理函数类型，形如 correlation_basic(r, s)
+        /// \param ref 参考信号
+        /// \param fun 频点处理函数，参考频谱为 0 的频点直接置 0
+        /// \return 流水线自身
+        template<RealSignal Tr, class fun_t>
+        spectral_pipeline_t &correlate(Tr const &ref, fun_t fun) {
+            if (_reference) throw std::logic_error("only one reference signal is supported");
+            _reference = std::make_shared<reference_t>();
+            _reference->values.resize(ref.values.size());
+            std::transform(ref.values.begin(), ref.values.end(), _reference->values.begin(), [](auto x) { return static_cast<t>(x); });
+            _reference->begin_time = floating_seconds(ref.begin_time);
+            _reference_fs = ref.sampling_frequency.template cast_to<Hz_t>();
+            _stages.emplace_back([reference = _reference, fun](spectrum_t &spectrum) {
+                auto const &R = reference->spectrum(spectrum.values.size());
+                for (auto p = spectrum.values.begin(), q = R.begin(); p < spectrum.values.end(); ++p, ++q)
+                    if (q->is_zero())
+                        *p = {};
+                    else if (!p->is_zero())
+                        *p = fun(*q, *p);
+            });
+            return *this;
+        }
+        
+        /// 以参考信号做频域互相关（匹配滤波），输出第 0 点对应零时延
+        /// \tparam mode 互相关模式
+        /// \tparam Tr 参考信号类型
+        /// \param ref 参考信号
+        /// \return 流水线自身
+        template<correlation_mode mode = correlation_mode::basic, RealSignal Tr>
+        spectral_pipeline_t &correlate(Tr const &ref) {
+            constexpr static auto
+                fun = mode == correlation_mode::basic
+                      ? correlation_basic<t>
+                      : mode == correlation_mode::phat
+                        ? correlation_phat<t>
+                        : correlation_noise_reduction<t>;
+            return correlate(ref, fun);
+        }
+        
+        /// 白化：各频点幅度归一
+        /// \return 流水线自身
+        spectral_pipeline_t &whiten() {
+            _stages.emplace_back([](spectrum_t &spectrum) {
+                for (auto &s : spectrum.values) s = s.normalize();
+            });
+            return *this;
+        }
+        
+        /// 追加自定义频点处理
+        /// \tparam fun_t 频点处理函数类型
+        /// \param fun 频点处理函数，参数为频点复数值和以 Hz 为单位的频率
+        /// \return 流水线自身
+        template<class fun_t>
+        spectral_pipeline_t &map(fun_t fun) {
+            _stages.emplace_back([fun](spectrum_t &spectrum) {
+                auto &values = spectrum.values;
+                const auto n = values.size();
+                const auto df = spectrum.sampling_frequency.value / n;
+                for (size_t i = 0; i < n; ++i)
+                    values[i] = fun(values[i], Hz_t{(i <= n / 2 ? -static_cast<float>(i) : static_cast<float>(n - i)) * df});
+            });
+            return *this;
+        }
+        
+        /// 执行流水线，仅做一次正变换和一次反变换
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 输入信号
+        /// \return 与输入等长的复信号；有参考信号时为解析互相关，起始时间为两信号起始时间之差
+        template<RealSignal _signal_t>
+        auto operator()(_signal_t const &signal) const {
+            using result_t = signal_t<complex_t<t>, typename _signal_t::frequency_t, typename _signal_t::time_t>;
+            using namespace std::chrono;
+            
+            const auto fs = signal.sampling_frequency.template cast_to<Hz_t>();
+            auto size = signal.values.size();
+            auto begin_time = floating_seconds(signal.begin_time);
+            if (_reference) {
+                if (_reference_fs != fs)
+                    throw std::invalid_argument("the two signals should be with same sampling_frequency");
+                size += _reference->values.size() - 1;
+                begin_time -= _reference->begin_time;
+            }
+            spectrum_t spectrum{
+                .values = std::vector<complex_t<t>>(enlarge_to_2_power(size), complex_t<t>(signal.values.back())),
+                .sampling_frequency = fs,
+                .begin_time = begin_time,
+            };
+            std::transform(signal.values.begin(), signal.values.end(), spectrum.values.begin(),
+                           [](auto x) { return complex_t<t>(static_cast<t>(x)); });
+            fft(spectrum.values);
+            for (auto const &stage : _stages) stage(spectrum);
+            ifft(spectrum.values);
+            spectrum.values.resize(signal.values.size());
+            return result_t{
+                .values = std::move(spectrum.values),
+                .sampling_frequency = signal.sampling_frequency,
+                .begin_time = duration_cast<typename _signal_t::time_t>(begin_time),
+            };
+        }
+        
+        /// 执行流水线并取模，即复包络
+        /// \tparam _signal_t 实信号类型
+        /// \param signal 输入信号
+        /// \return 与输入等长的实信号
+        template<RealSignal _signal_t>
+        auto envelope(_signal_t const &signal) const {
+            return mechdancer::abs((*this)(signal));
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_SPECTRAL_PIPELINE_H
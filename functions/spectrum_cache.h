@@ -0,0 +1,169 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SPECTRUM_CACHE_H
+#define DSP_SIMULATION_SPECTRUM_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+
+#include "fft.h"
+#include "../types/packed12_t.hpp"
+
+namespace mechdancer {
+    /// 计算频谱时补齐到 2 的幂的方式
+    enum class padding_mode {
+        zero, // 补 0
+        hold, // 重复最后一个采样
+    };
+    
+    /// 带频谱缓存的实信号
+    /// 同一信号以相同长度、补齐方式求频谱时只计算一次；通过 modify 修改信号会使缓存失效。
+    /// 缓存的频谱以 std::allocator 分配，只在首次计算时分配；取出时复制到调用方指定分配器的缓冲
+    /// \tparam _signal_t 实信号类型
+    template<RealSignal _signal_t>
+    class cached_signal_t {
+    public:
+        using signal_type = _signal_t;
+        using value_t = typename _signal_t::value_t;
+        using frequency_t = typename _signal_t::frequency_t;
+        using time_t = typename _signal_t::time_t;
+        /// 频谱数值类型，整型信号以 float 计算
+        using spectrum_value_t = std::conditional_t<std::is_floating_point_v<value_t>, value_t, float>;
+        using spectrum_t = std::vector<complex_t<spectrum_value_t>>;
+    
+    private:
+        _signal_t _signal;
+        mutable std::map<std::pair<size_t, padding_mode>, spectrum_t> _spectrums;
+        mutable std::mutex _mutex;
+    
+    public:
+        explicit cached_signal_t(_signal_t signal) : _signal(std::move(signal)) {}
+        
+        cached_signal_t(cached_signal_t const &others) : _signal(others._signal) {
+            std::lock_guard<std::mutex> _(others._mutex);
+            _spectrums = others._spectrums;
+        }
+        
+        cached_signal_t(cached_signal_t &&others) noexcept
+            : _signal(std::move(others._signal)),
+              _spectrums(std::move(others._spectrums)) {}
+        
+        /// 只读访问信号
+        [[nodiscard]] _signal_t const &signal() const { return _signal; }
+        
+        /// 修改信号，并清空频谱缓存
+        /// \tparam fun_t 修改函数类型
+        /// \param fun 修改函数，参数为信号的引用
+        template<class fun_t>
+        void modify(fun_t fun) {
+            fun(_signal);
+            invalidate();
+        }
+        
+        /// 清空频谱缓存
+        void invalidate() {
+            std::lock_guard<std::mutex> _(_mutex);
+            _spectrums.clear();
+        }
+        
+        /// 已缓存的频谱数量
+        [[nodiscard]] size_t cached_count() const {
+            std::lock_guard<std::mutex> _(_mutex);
+            return _spectrums.size();
+        }
+        
+        /// 取得频谱，未缓存时计算
+        /// \param size 变换长度，必须为 2 的幂
+        /// \param mode 补齐方式
+        /// \return 频谱
+        spectrum_t const &spectrum(size_t size, padding_mode mode) const {
+            std::lock_guard<std::mutex> _(_mutex);
+            auto key = std::make_pair(size, mode);
+            auto p = _spectrums.find(key);
+            if (p != _spectrums.end()) return p->second;
+            auto const &values = _signal.values;
+            auto pad = mode == padding_mode::hold && !values.empty()
+                       ? complex_t<spectrum_value_t>(values.back())
+                       : complex_t<spectrum_value_t>{};
+            auto memory = spectrum_t(size, pad);
+            std::transform(values.begin(), values.begin() + std::min(size, values.size()), memory.begin(),
+                           [](auto x) { return complex_t<spectrum_value_t>(static_cast<spectrum_value_t>(x)); });
+            fft(memory);
+            return _spectrums.emplace(key, std::move(memory)).first->second;
+        }
+    };
+    
+    template<class t>
+    struct is_cached_signal : std::false_type {};
+    
+    template<class t>
+    struct is_cached_signal<cached_signal_t<t>> : std::true_type {};
+    
+    /// 带频谱缓存的实信号
+    template<class t>
+    concept CachedSignal = is_cached_signal<std::remove_cvref_t<t>>::value;
+    
+    /// 可以求频谱的实信号：普通实信号或带频谱缓存的实信号
+    template<class t>
+    concept SpectrumSource = RealSignal<t> || CachedSignal<t>;
+    
+    /// 取得信号本体
+    /// \param signal 实信号或带缓存的实信号
+    /// \return 信号的只读引用
+    template<SpectrumSource t>
+    auto const &source_of(t const &signal) {
+        if constexpr (CachedSignal<t>)
+            return signal.signal();
+        else
+            return signal;
+    }
+    
+    /// 频谱来源对应的信号类型
+    template<SpectrumSource t>
+    using source_signal_t = std::remove_cvref_t<decltype(source_of(std::declval<t const &>()))>;
+    
+    /// 计算或从缓存中取得指定长度的频谱
+    /// \tparam target_t 复数值类型
+    /// \tparam allocator_t 频谱缓冲的分配器类型，通常为信号的分配器重绑定到复数
+    /// \tparam t 频谱来源类型
+    /// \param signal 实信号或带缓存的实信号
+    /// \param size 变换长度，必须为 2 的幂
+    /// \param mode 补齐方式
+    /// \return 频谱副本
+    template<Number target_t, class allocator_t = std::allocator<complex_t<target_t>>, SpectrumSource t>
+    std::vector<complex_t<target_t>, allocator_t> spectrum_of(t const &signal, size_t size, padding_mode mode) {
+        if constexpr (CachedSignal<t>) {
+            if constexpr (std::is_same_v<typename t::spectrum_value_t, target_t>) {
+                auto const &spectrum = signal.spectrum(size, mode);
+                return {spectrum.begin(), spectrum.end()};
+            } else
+                return spectrum_of<target_t, allocator_t>(signal.signal(), size, mode);
+        } else if constexpr (PackedSignal<t>) {
+            // 直接解包到 FFT 缓冲
+            auto const &values = signal.values;
+            auto pad = mode == padding_mode::hold && !values.empty()
+                       ? complex_t<target_t>(values.back())
+                       : complex_t<target_t>{};
+            auto result = std::vector<complex_t<target_t>, allocator_t>(size, pad);
+            unpack(values, 0, std::min(size, values.size()), result.data());
+            fft(result);
+            return result;
+        } else {
+            auto const &values = signal.values;
+            auto pad = mode == padding_mode::hold && !values.empty()
+                       ? complex_t<target_t>(values.back())
+                       : complex_t<target_t>{};
+            auto result = std::vector<complex_t<target_t>, allocator_t>(size, pad);
+            std::transform(values.begin(), values.begin() + std::min(size, values.size()), result.begin(),
+                           [](auto x) { return complex_t<target_t>(x); });
+            fft(result);
+            return result;
+        }
+    }
+}
+
+#endif // DSP_SIMULATION_SPECTRUM_CACHE_H
@@ -0,0 +1,88 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SPLIT_SPECTRUM_H
+#define DSP_SIMULATION_SPLIT_SPECTRUM_H
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "process_real.h"
+#include "../types/split_signal_t.hpp"
+
+namespace mechdancer {
+    /// 频域互相关的逐点运算，实部、虚部分开存储的版本
+    /// 结果与 correlation 中对应的 correlation_basic/phat/noise_reduction 相同：
+    /// 参考谱或目标谱为 0 的点结果为 0
+    /// \tparam mode 互相关模式
+    /// \param r 参考谱
+    /// \param s 目标谱，原位替换为互相关谱
+    template<correlation_mode mode = correlation_mode::basic, Number t, class a, class b>
+    void correlate_spectrum(split_complex_vector_t<t, a> const &r, split_complex_vector_t<t, b> &s) {
+        if (r.size() != s.size()) throw std::invalid_argument("the two spectrums should be with same size");
+        const auto n = s.size();
+        auto const *rr = r.re.data(), *ri = r.im.data();
+        auto *sr = s.re.data(), *si = s.im.data();
+        for (size_t i = 0; i < n; ++i) {
+            // conj(r) * s
+            auto re = rr[i] * sr[i] + ri[i] * si[i];
+            auto im = rr[i] * si[i] - ri[i] * sr[i];
+            if constexpr (mode == correlation_mode::basic) {
+                sr[i] = re;
+                si[i] = im;
+            } else {
+                auto l = mode == correlation_mode::phat
+                         ? std::sqrt(re * re + im * im)
+                         : std::sqrt(sr[i] * sr[i] + si[i] * si[i]);
+                // l 为 0 时乘积也为 0，分母换成 1 即可免去分支，便于向量化
+                auto k = 1 / (l + (l == 0));
+                sr[i] = re * k;
+                si[i] = im * k;
+            }
+        }
+    }
+    
+    /// 频域互相关，实部、虚部分开存储的版本
+    /// \tparam mode 互相关模式
+    /// \param ref 参考谱
+    /// \param signal 目标谱，原位替换为互相关谱
+    template<correlation_mode mode = correlation_mode::basic, SplitComplexSignal t, SplitComplexSignal u>
+    void correlate_spectrum(t const &ref, u &signal) {
+        if (ref.sampling_frequency != signal.sampling_frequency)
+            throw std::invalid_argument("the two signals should be with same sampling_frequency");
+        correlate_spectrum<mode>(ref.values, signal.values);
+    }
+    
+    /// 带限白化互相关：[begin, end) 内 s = s conj(r) / (|s| √|r|)，范围外置 0
+    /// 参考谱为 0 的点结果为 0，目标谱为 0 的点保持 0
+    /// \param r 参考谱
+    /// \param s 目标谱，原位替换
+    /// \param begin 起始频点
+    /// \param end 结束频点
+    template<Number t, class a, class b>
+    void whiten(split_complex_vector_t<t, a> const &r, split_complex_vector_t<t, b> &s, size_t begin, size_t end) {
+        if (r.size() != s.size()) throw std::invalid_argument("the two spectrums should be with same size");
+        end = std::min(end, s.size());
+        begin = std::min(begin, end);
+        auto const *rr = r.re.data(), *ri = r.im.data();
+        auto *sr = s.re.data(), *si = s.im.data();
+        std::fill(sr, sr + begin, t{});
+        std::fill(si, si + begin, t{});
+        for (size_t i = begin; i < end; ++i) {
+            auto lr = std::sqrt(rr[i] * rr[i] + ri[i] * ri[i]);
+            auto l = std::sqrt(lr) * std::sqrt(sr[i] * sr[i] + si[i] * si[i]);
+            // 任一谱为 0 时乘积为 0，分母换成 1 即可免去分支
+            auto k = 1 / (l + (l == 0));
+            auto re = rr[i] * sr[i] + ri[i] * si[i];
+            auto im = rr[i] * si[i] - ri[i] * sr[i];
+            sr[i] = re * k;
+            si[i] = im * k;
+        }
+        std::fill(sr + end, sr + s.size(), t{});
+        std::fill(si + end, si + s.size(), t{});
+    }
+}
+
+#endif // DSP_SIMULATION_SPLIT_SPECTRUM_H
@@ -0,0 +1,205 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_TEXT_LOADER_H
+#define DSP_SIMULATION_TEXT_LOADER_H
+
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+
+#include "mapped_file.hh"
+
+namespace mechdancer {
+    /// 解析一段以空白分隔的数值文本，不受 locale 影响
+    /// 与 std::istream >> 相同，遇到无法解析的内容即停止
+    /// \tparam value_t 数值类型
+    /// \param text 文本
+    /// \param out 输出
+    /// \return 是否完整解析到末尾
+    template<class value_t>
+    bool parse_numbers(std::string_view text, std::vector<value_t> &out) {
+        auto p = text.data();
+        const auto end = p + text.size();
+        auto blank = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f'; };
+        while (true) {
+            while (p < end && blank(*p)) ++p;
+            if (p == end) return true;
+            if (*p == '+') ++p; // std::from_chars 不接受正号
+            value_t value;
+            auto [next, error] = std::from_chars(p, end, value);
+            if (error != std::errc{}) return false;
+            out.push_back(value);
+            p = next;
+        }
+    }
+    
+    /// 分块并行解析数值文本
+    /// 按大致均分的位置向后找到换行（没有换行时找任意空白）切分，各块独立解析后拼接
+    /// \tparam value_t 数值类型
+    /// \param text 文本
+    /// \param threads 线程数
+    /// \return 数值
+    template<class value_t>
+    std::vector<value_t> parse_numbers(std::string_view text, size_t threads = std::thread::hardware_concurrency()) {
+        constexpr static size_t MIN_CHUNK = size_t{1} << 16;
+        threads = std::clamp<size_t>(threads, 1, std::max<size_t>(text.size() / MIN_CHUNK, 1));
+        
+        std::vector<size_t> bounds{0};
+        for (size_t i = 1; i < threads; ++i) {
+            auto p = std::max(text.size() * i / threads, bounds.back());
+            auto q = text.find('\n', p);
+            if (q == std::string_view::npos) q = text.find_first_of(" \t\r\v\f", p);
+            bounds.push_back(q == std::string_view::npos ? text.size() : q);
+        }
+        bounds.push_back(text.size());
+        
+        std::vector<std::vector<value_t>> parts(threads);
+        std::vector<char> complete(threads);
+        {
+            std::vector<std::thread> tasks;
+            for (size_t i = 1; i < threads; ++i)
+                tasks.emplace_back([&, i] { complete[i] = parse_numbers(text.substr(bounds[i], bounds[i + 1] - bounds[i]), parts[i]); });
+            complete[0] = parse_numbers(text.substr(0, bounds[1]), parts[0]);
+            for (auto &task : tasks) task.join();
+        }
+        
+        size_t size = 0, used = 0;
+        // 某块中途失败时，其后的块全部丢弃
+        while (used < threads) {
+            size += parts[used].size();
+            if (!complete[used++]) break;
+        }
+        std::vector<value_t> result;
+        result.reserve(size);
+        for (size_t i = 0; i < used; ++i) result.insert(result.end(), parts[i].begin(), parts[i].end());
+        return result;
+    }
+    
+    /// 文本数据文件的二进制缓存
+    /// 缓存文件与数据文件同目录，名为数据文件名加 .cache，
+    /// 记录数据文件的字节数和修改时间，两者不变时直接读入缓存
+    /// \tparam value_t 缓存的元素类型
+    /// \tparam parse_t 解析文本时的数值类型，不同的解析类型得到的结果可能不同，也记入缓存
+    template<class value_t, class parse_t = value_t>
+    class text_cache_t {
+        constexpr static char MAGIC[8] = {'D', 'S', 'P', 'C', 'A', 'C', 'H', '2'};
+        
+        struct header_t {
+            char magic[8];
+            uint64_t file_size;
+            int64_t modified;
+            uint32_t element_size;
+            uint32_t is_floating;
+            uint32_t parse_size;
+            uint32_t parse_is_floating;
+            uint64_t count;
+        };
+        
+        std::filesystem::path _source, _cache;
+        header_t _key{};
+    
+    public:
+        explicit text_cache_t(std::filesystem::path source)
+            : _source(std::move(source)) {
+            _cache = _source;
+            _cache += ".cache";
+            std::memcpy(_key.magic, MAGIC, sizeof MAGIC);
+            _key.file_size = std::filesystem::file_size(_source);
+            _key.modified = static_cast<int64_t>(std::filesystem::last_write_time(_source).time_since_epoch().count());
+            _key.element_size = sizeof(value_t);
+            _key.is_floating = std::is_floating_point_v<value_t>;
+            _key.parse_size = sizeof(parse_t);
+            _key.parse_is_floating = std::is_floating_point_v<parse_t>;
+        }
+        
+        [[nodiscard]] std::filesystem::path const &path() const { return _cache; }
+        
+        /// 读入缓存
+        /// \param out 输出
+        /// \return 缓存存在且有效，记录的数量与缓存文件的大小不符时也视为无效
+        bool read(std::vector<value_t> &out) const {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(_cache, error);
+            if (error || size < sizeof(header_t)) return false;
+            std::ifstream file(_cache, std::ios_base::binary);
+            header_t header;
+            if (!file.read(reinterpret_cast<char *>(&header), sizeof header)) return false;
+            if (std::memcmp(header.magic, _key.magic, sizeof MAGIC) != 0
+                || header.file_size != _key.file_size
+                || header.modified != _key.modified
+                || header.element_size != _key.element_size
+                || header.is_floating != _key.is_floating
+                || header.parse_size != _key.parse_size
+                || header.parse_is_floating != _key.parse_is_floating
+                || header.count != (size - sizeof header) / sizeof(value_t)
+                || (size - sizeof header) % sizeof(value_t) != 0)
+                return false;
+            out.resize(static_cast<size_t>(header.count));
+            if (!file.read(reinterpret_cast<char *>(out.data()), static_cast<std::streamsize>(out.size() * sizeof(value_t)))) {
+                out.clear();
+                return false;
+            }
+            return true;
+        }
+        
+        /// 写出缓存，先写临时文件再改名，并发的读者不会读到一半的缓存；失败时静默放弃
+        void write(std::vector<value_t> const &values) const {
+            auto temp = _cache;
+            temp += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream file(temp, std::ios_base::binary);
+                auto header = _key;
+                header.count = values.size();
+                file.write(reinterpret_cast<char const *>(&header), sizeof header);
+                file.write(reinterpret_cast<char const *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(value_t)));
+                if (!file) {
+                    file.close();
+                    std::error_code _;
+                    std::filesystem::remove(temp, _);
+                    return;
+                }
+            }
+            std::error_code error;
+            std::filesystem::rename(temp, _cache, error);
+            if (error) std::filesystem::remove(temp, error);
+        }
+    };
+    
+    /// 加载以空白分隔的数值文本文件
+    /// 有有效的缓存时直接读入；否则映射文件并行解析，并写出缓存供下次使用
+    /// \tparam value_t 文件中的数值类型
+    /// \tparam element_t 结果的元素类型
+    /// \param file_name 文件名
+    /// \return 数值，文件不存在时为空
+    template<class value_t = float, class element_t = value_t>
+    std::vector<element_t> load_numbers(std::string const &file_name) {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(file_name, error)) return {};
+        auto cache = text_cache_t<element_t, value_t>(file_name);
+        std::vector<element_t> result;
+        if (cache.read(result)) return result;
+        {
+            auto file = mapped_file_t(file_name);
+            auto text = std::string_view(static_cast<char const *>(file.data()), file.size());
+            if constexpr (std::is_same_v<value_t, element_t>)
+                result = parse_numbers<value_t>(text);
+            else {
+                auto values = parse_numbers<value_t>(text);
+                result.assign(values.begin(), values.end());
+            }
+        }
+        cache.write(result);
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_TEXT_LOADER_H
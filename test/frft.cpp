@@ -9,7 +9,7 @@ using namespace mechdancer;
 
 int main() {
     using namespace std::chrono_literals;
-    constexpr static auto MAIN_FS = 500_kHz; // 
+    constexpr static auto MAIN_FS = 500_kHz; // 采样率
     auto order = best_order(16.384ms, MAIN_FS, 1ms, -1_kHz);
     std::cout << "the best order = " << order << std::endl;
     std::cout << "transformation ratio = " << std::abs(std::sin(PI / 2 * (order - 1))) << std::endl;
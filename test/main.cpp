@@ -2,11 +2,13 @@
 #include <algorithm>
 #include <filesystem>
 #include <sstream>
+#include <deque>
 #include <thread>
 #include <mutex>
 
 #include "../functions/builders.h"
 #include "../functions/process_real.h"
+#include "../functions/capture_reader.h"
 #include "../functions/script_builder.hh"
 
 using namespace mechdancer;
@@ -14,35 +16,22 @@ using namespace mechdancer;
 struct peak_t { size_t index; float value; };
 
 int main() {
-    // region ׼
+    // region 准备环境
     using namespace std::chrono;
     using namespace std::chrono_literals;
     script_builder_t script_builder("data");
     // endregion
-    std::vector<std::vector<unsigned short>> slices;
     std::ofstream("../data/README.md")
-        << "# ˵\n"
-           "- źԴ107.BIN\n"
-           "- ź˵13 "
-           "- 㷨ư׻";
-    { // ؽź
-        constexpr static auto path = "../107.BIN";
-        auto size = std::filesystem::file_size(path);
-        auto signal = std::vector<unsigned short>(size / 2);
-        std::ifstream(path, std::ios_base::binary)
-            .read(reinterpret_cast<char *>(signal.data()), size);
-        for (auto p = signal.begin(); p < signal.end(); ++p)
-            if (*p > 4096) {
-                slices.emplace_back();
-                slices.back().push_back(*p - 4096);
-            } else if (slices.back().size() < 100000)
-                slices.back().push_back(*p);
-        std::cout << "parsed " << slices.size() << " groups of signal" << std::endl;
-    }
-    constexpr static auto MAIN_FS = 1_MHz; // 
-    // region Դŵ
-    auto transceiver = load("../2048_1M_0.txt", MAIN_FS, 0s);
-    transceiver.values.erase(transceiver.values.begin() + 1600, transceiver.values.end());
+        << "# 说明\n"
+           "- 信号来源：107.BIN\n"
+           "- 信号说明：13 米"
+           "- 算法：噪声抑制白化互相关";
+    constexpr static auto MAIN_FS = 1_MHz; // 采样率
+    // 映射接收信号，后台建立帧索引
+    capture_reader_t capture("../107.BIN", MAIN_FS, floating_seconds(0));
+    // region 信源信道仿真
+    auto transceiver_full = load("../2048_1M_0.txt", MAIN_FS, 0s);
+    auto transceiver = slice(transceiver_full, 0, 1600);
     // auto excitation = sample(1'000, chirp(38_kHz, 42_kHz, 1ms), MAIN_FS, 0s);
     auto excitation = sample(1000, [](auto time) {
         using namespace std::chrono;
@@ -50,11 +39,11 @@ int main() {
         auto x = chirp(38_kHz, 42_kHz, .8ms);
         return t < .8ms ? x(t) : t < .91ms ? -x(t - .8ms) : 0;
     }, MAIN_FS, 0s);
-    auto reference = convolution(transceiver, excitation); // ź
+    auto reference = convolution(transceiver, excitation); // 构造接收信号
     SAVE_SIGNAL_AUTO(script_builder, reference);
     auto self_corr = correlation<correlation_mode::basic>(reference, reference);
     SAVE_SIGNAL_AUTO(script_builder, self_corr);
-    { // 췢ź
+    { // 构造发送信号
         auto sending = signal_of<unsigned short>(excitation.values.size(), excitation.sampling_frequency, excitation.begin_time);
         std::transform(excitation.values.begin(), excitation.values.end(), sending.values.begin(),
                        [](auto x) { return static_cast<unsigned short>(std::round(x * 2000 + 2048)); });
@@ -75,22 +64,21 @@ int main() {
     }
     
     std::vector<std::thread> tasks;
-    std::vector<peak_t> result(slices.size());
+    std::deque<peak_t> result;
     
     std::mutex mutex;
-    for (auto i = 0; i < slices.size(); ++i)
-        tasks.emplace_back([&, i] {
-            signal_t<unsigned short, decltype(MAIN_FS), floating_seconds>
-                received{
-                .values = std::move(slices[i]),
-                .sampling_frequency = MAIN_FS,
-                .begin_time = floating_seconds(0),
-            };
-            auto size = enlarge_to_2_power(std::max(reference.values.size(), received.values.size()));
+    // 帧的范围一确定就开始处理
+    auto groups = capture.for_each_frame([&](size_t i, auto const &frame) {
+        auto &peak = result.emplace_back();
+        tasks.emplace_back([&, i, received = frame.slice(0, 100000)] {
+            auto length = received.values.size();
+            auto size = enlarge_to_2_power(std::max(reference.values.size(), length));
             auto R = complex(reference);
-            auto S = complex<decltype(received), float>(received);
             R.values.resize(size, R.values.back());
-            S.values.resize(size, S.values.back());
+            auto S = signal_of<complex_t<float>>(size, MAIN_FS, received.begin_time);
+            std::transform(received.values.begin(), received.values.end(), S.values.begin(),
+                           [](auto x) { return complex_t<float>(x); });
+            std::fill(S.values.begin() + length, S.values.end(), S.values[length - 1]);
             fft(R.values);
             fft(S.values);
             {
@@ -108,26 +96,24 @@ int main() {
                 } while (++q < e);
             }
             ifft(S.values);
-            S.values.erase(S.values.begin() + received.values.size(), S.values.end());
-            auto spectrum = mechdancer::abs(S);
+            S.values.erase(S.values.begin() + length, S.values.end());
+            auto spectrum = mechdancer::abs(std::move(S));
             {
-                result[i] = {0, 0};
-                // ǰ
-                // ͺ󲿷еź
-                auto end = spectrum.values.end() - reference.values.size() + 1;
-                // ҵֵ
-                auto max = spectrum.values.begin();
-                for (auto p = max + 1; p < end; ++p)
-                    if (*p > *max) max = p;
-                // ҵ״δﵽֵ 40% λ
-                auto p = max > spectrum.values.begin() + 6000 ? max - 6000 : spectrum.values.begin();
-                result[i].value = *max * .26f;
-                while (*p++ < result[i].value);
-                // ҵλúĵһֵ
-                while (*p > result[i].value)
-                    result[i].value = *p++;
-                *p = 0;
-                result[i].index = p - spectrum.values.begin();
+                // 不搜索超前部分
+                // 搜索滞后部分中的完整信号
+                auto end = spectrum.values.size() - reference.values.size() + 1;
+                // 找到最大值
+                auto max = argmax(spectrum, 0, end);
+                // 找到首次达到最大值 26% 的位置
+                auto threshold = spectrum.values[max] * .26f;
+                auto p = first_crossing(spectrum, threshold, max > 6000 ? max - 6000 : 0) + 1;
+                // 从下一个采样开始，找到高于阈值的第一个极大值，记录其后一个位置；不再上升时记为阈值
+                if (spectrum.values[p] > threshold) {
+                    auto top = local_maximum(spectrum, p);
+                    peak = {top + 1, spectrum.values[top]};
+                } else
+                    peak = {p, threshold};
+                spectrum.values[peak.index] = 0;
             }
             std::stringstream string_builder;
             string_builder << "group" << i;
@@ -135,10 +121,11 @@ int main() {
             {
                 std::lock_guard<decltype(mutex)> _(mutex);
                 std::cout << name << "(" << spectrum.values.size() << ") saving" << std::endl;
-                name = script_builder.save(name);
             }
-            SAVE_SIGNAL(name, spectrum);
+            script_builder.export_signal(name, std::move(spectrum));
         });
+    });
+    std::cout << "parsed " << groups << " groups of signal" << std::endl;
     for (auto &task : tasks) task.join();
     auto file = std::ofstream(script_builder.save("result"));
     result.erase(result.end() - 1);
@@ -2,58 +2,51 @@
 
 #include "../functions/builders.h"
 #include "../functions/process_real.h"
+#include "../functions/ddc.h"
+#include "../functions/multipath.h"
 #include "../functions/script_builder.hh"
 
 using namespace mechdancer;
 using namespace std::chrono;
 
-/// Ϊ̽ͷ
-/// \tparam _signal_t ź
-/// \param base ź
-/// \return ѵź
+/// 为多探头调制
+/// \tparam _signal_t 信号类型
+/// \param base 待调信号
+/// \return 已调信号
 template<class _signal_t> requires RealSignal<_signal_t>
 auto modulate(_signal_t base) {
-    auto excitation31 = base * sample(base.values.size(), sin(29_kHz), 1_MHz, 0_sf);
-    auto excitation40 = base * sample(base.values.size(), sin(34_kHz), 1_MHz, 0_sf);
-    bandpass(excitation31, 29_kHz, 33_kHz);
-    bandpass(excitation40, 38_kHz, 42_kHz);
+    // 本振初相 -π/2，即以 sin 载波混频
+    auto excitation31 = duc_t<float>(29_kHz, 14.5_kHz, 1, 1_MHz, butterworth_bandpass(4, 29_kHz, 33_kHz, 1_MHz), -PI / 2)(base);
+    auto excitation40 = duc_t<float>(34_kHz, 17.0_kHz, 1, 1_MHz, butterworth_bandpass(4, 38_kHz, 42_kHz, 1_MHz), -PI / 2)(base);
     return excitation31 + excitation40;
 }
 
-/// Ϊ̽ͷ
-/// \tparam _signal_t ź
-/// \param received ѵź
-/// \return ź
+/// 为多探头解调
+/// \tparam _signal_t 信号类型
+/// \param received 叠加信号
+/// \return 解调信号
 template<class _signal_t> requires RealSignal<_signal_t>
-auto demodulate(_signal_t received) {
-    auto received31 = received;
-    auto received40 = received;
-    bandpass(received31, 29_kHz, 33_kHz);
-    bandpass(received40, 38_kHz, 42_kHz);
-    auto temp1 = received31 * sample(received31.values.size(), sin(29_kHz), 1_MHz, 0_sf);
-    auto temp2 = received40 * sample(received40.values.size(), sin(34_kHz), 1_MHz, 0_sf);
-    bandpass(temp1, 0_kHz, 14.5_kHz);
-    bandpass(temp2, 0_kHz, 17.0_kHz);
+auto demodulate(_signal_t const &received) {
+    // 选带、混频、低通在一次遍历中完成
+    auto temp1 = real(ddc_t<float>(29_kHz, 14.5_kHz, 1, 1_MHz, butterworth_bandpass(4, 29_kHz, 33_kHz, 1_MHz), -PI / 2)(received));
+    auto temp2 = real(ddc_t<float>(34_kHz, 17.0_kHz, 1, 1_MHz, butterworth_bandpass(4, 38_kHz, 42_kHz, 1_MHz), -PI / 2)(received));
     return temp1 + temp2;
 }
 
 int main() {
     auto script_builder = script_builder_t("data");
     
-    // ŵ
+    // 构造信道
     auto transceiver = load("../31+40_2048_1M.txt", 1_MHz, floating_seconds(0));
-    auto multi_path = signal_of(800, 1_MHz, 0_sf);
-    multi_path.values.front() = 1;
-    multi_path.values[400] = 2;
-    multi_path.values.back() = 3;
+    auto multi_path = sparse_channel_t<>{{0us, 1}, {400us, 2}, {799us, 3}};
     
-    // ߴ
+    // 单边带调制
     auto base = sample(4096, chirp(7_kHz, -7_kHz, 4096us), 1_MHz, 0_sf);
     auto excitation = modulate(base);
     
-    // 
+    // 解调
     auto reference = demodulate(convolution(excitation, transceiver));
-    auto received = convolution(excitation, convolution(transceiver, multi_path));
+    auto received = convolution(excitation, multi_path(transceiver));
     auto recovered = demodulate(received);
     
     auto size = 65536;
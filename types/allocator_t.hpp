@@ -0,0 +1,222 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_ALLOCATOR_T_HPP
+#define DSP_SIMULATION_ALLOCATOR_T_HPP
+
+#include <new>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace mechdancer {
+    /// 缓存行（也是 AVX-512 向量）的字节数
+    constexpr static size_t CACHE_LINE = 64;
+    
+    /// 按指定字节数对齐的分配器
+    /// \tparam t 元素类型
+    /// \tparam alignment 对齐字节数
+    template<class t, size_t alignment = CACHE_LINE>
+    struct aligned_allocator_t {
+        using value_type = t;
+        using is_always_equal = std::true_type;
+        
+        template<class u>
+        struct rebind { using other = aligned_allocator_t<u, alignment>; };
+        
+        aligned_allocator_t() = default;
+        
+        template<class u>
+        constexpr aligned_allocator_t(aligned_allocator_t<u, alignment> const &) noexcept {}
+        
+        t *allocate(size_t n) {
+            return static_cast<t *>(::operator new(n * sizeof(t), std::align_val_t(alignment)));
+        }
+        
+        void deallocate(t *p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+        
+        template<class u>
+        bool operator==(aligned_allocator_t<u, alignment> const &) const noexcept { return true; }
+    };
+    
+    /// 内存池统计
+    struct pool_statistics_t {
+        size_t allocations = 0,        // 分配次数
+               reuses = 0,             // 其中由池中回收的块满足的次数
+               system_allocations = 0, // 向系统申请的次数
+               deallocations = 0,      // 释放次数
+               bytes_in_use = 0,       // 正在使用的字节数（按块大小计）
+               peak_bytes = 0,         // 正在使用的字节数峰值
+               bytes_cached = 0;       // 池中缓存待用的字节数
+        
+        /// 统计区间内的增量，峰值取后者
+        pool_statistics_t operator-(pool_statistics_t const &others) const {
+            return {
+                .allocations = allocations - others.allocations,
+                .reuses = reuses - others.reuses,
+                .system_allocations = system_allocations - others.system_allocations,
+                .deallocations = deallocations - others.deallocations,
+                .bytes_in_use = bytes_in_use,
+                .peak_bytes = peak_bytes,
+                .bytes_cached = bytes_cached,
+            };
+        }
+    };
+    
+    /// 按 2 的幂分级的线程局部内存池
+    /// 释放的块按大小级别挂在空闲表上，下次同级别的分配直接复用，
+    /// 反复执行的处理流程在第一轮之后不再向系统申请内存。
+    /// 块可以在其他线程释放，此时归入释放线程的池
+    class memory_pool_t {
+        constexpr static size_t MIN_CLASS = 6, // 最小块 64 字节
+                                CLASSES = 48;
+        
+        std::array<std::vector<void *>, CLASSES> _free{};
+        pool_statistics_t _statistics{};
+        
+        static size_t class_of(size_t bytes) {
+            size_t c = MIN_CLASS;
+            while ((size_t{1} << c) < bytes) ++c;
+            return c;
+        }
+        
+        memory_pool_t() = default;
+        
+        /// 线程退出时池先于某些线程局部对象析构，此后的分配、释放直接交给系统
+        static bool &destroyed() {
+            thread_local bool value = false;
+            return value;
+        }
+    
+    public:
+        /// 从当前线程的池分配
+        static void *acquire(size_t bytes) {
+            if (destroyed()) return ::operator new(size_t{1} << class_of(std::max<size_t>(bytes, 1)), std::align_val_t(CACHE_LINE));
+            return local().allocate(bytes);
+        }
+        
+        /// 归还到当前线程的池
+        static void recycle(void *p, size_t bytes) {
+            if (destroyed()) ::operator delete(p, std::align_val_t(CACHE_LINE));
+            else local().deallocate(p, bytes);
+        }
+        
+        memory_pool_t(memory_pool_t const &) = delete;
+        
+        memory_pool_t &operator=(memory_pool_t const &) = delete;
+        
+        ~memory_pool_t() {
+            release();
+            destroyed() = true;
+        }
+        
+        /// 当前线程的内存池
+        static memory_pool_t &local() {
+            thread_local memory_pool_t pool;
+            return pool;
+        }
+        
+        /// 分配至少 bytes 字节、按缓存行对齐的块
+        void *allocate(size_t bytes) {
+            const auto c = class_of(std::max<size_t>(bytes, 1));
+            const auto size = size_t{1} << c;
+            ++_statistics.allocations;
+            _statistics.peak_bytes = std::max(_statistics.peak_bytes, _statistics.bytes_in_use += size);
+            auto &list = _free[c - MIN_CLASS];
+            if (!list.empty()) {
+                ++_statistics.reuses;
+                _statistics.bytes_cached -= size;
+                auto p = list.back();
+                list.pop_back();
+                return p;
+            }
+            ++_statistics.system_allocations;
+            return ::operator new(size, std::align_val_t(CACHE_LINE));
+        }
+        
+        /// 归还块，块不还给系统
+        void deallocate(void *p, size_t bytes) {
+            const auto c = class_of(std::max<size_t>(bytes, 1));
+            const auto size = size_t{1} << c;
+            ++_statistics.deallocations;
+            // 其他线程分配的块计入本线程时，防止下溢
+            _statistics.bytes_in_use -= std::min(_statistics.bytes_in_use, size);
+            _statistics.bytes_cached += size;
+            _free[c - MIN_CLASS].push_back(p);
+        }
+        
+        /// 把缓存的块全部还给系统
+        void release() {
+            for (size_t i = 0; i < CLASSES; ++i) {
+                for (auto p : _free[i]) ::operator delete(p, std::align_val_t(CACHE_LINE));
+                _free[i].clear();
+                _free[i].shrink_to_fit();
+            }
+            _statistics.bytes_cached = 0;
+        }
+        
+        [[nodiscard]] pool_statistics_t const &statistics() const { return _statistics; }
+        
+        /// 清零计数，保留正在使用和缓存的字节数
+        void reset_statistics() {
+            _statistics = {
+                .bytes_in_use = _statistics.bytes_in_use,
+                .peak_bytes = _statistics.bytes_in_use,
+                .bytes_cached = _statistics.bytes_cached,
+            };
+        }
+    };
+    
+    /// 从线程局部内存池分配的分配器，块按缓存行对齐
+    /// \tparam t 元素类型
+    template<class t>
+    struct pool_allocator_t {
+        using value_type = t;
+        using is_always_equal = std::true_type;
+        
+        template<class u>
+        struct rebind { using other = pool_allocator_t<u>; };
+        
+        pool_allocator_t() = default;
+        
+        template<class u>
+        constexpr pool_allocator_t(pool_allocator_t<u> const &) noexcept {}
+        
+        t *allocate(size_t n) {
+            return static_cast<t *>(memory_pool_t::acquire(n * sizeof(t)));
+        }
+        
+        void deallocate(t *p, size_t n) noexcept {
+            memory_pool_t::recycle(p, n * sizeof(t));
+        }
+        
+        template<class u>
+        bool operator==(pool_allocator_t<u> const &) const noexcept { return true; }
+    };
+    
+    /// 统计一段处理流程在当前线程的内存池上的分配情况
+    /// 例如：
+    /// auto scope = pool_scope_t();
+    /// ... 处理 ...
+    /// auto s = scope.statistics(); // s.system_allocations 为 0 即达到无分配的稳态
+    class pool_scope_t {
+        pool_statistics_t _begin;
+    
+    public:
+        pool_scope_t() : _begin(memory_pool_t::local().statistics()) {}
+        
+        /// 从构造到现在的统计增量
+        [[nodiscard]] pool_statistics_t statistics() const {
+            return memory_pool_t::local().statistics() - _begin;
+        }
+        
+        /// 重新开始统计
+        void restart() { _begin = memory_pool_t::local().statistics(); }
+    };
+}
+
+#endif // DSP_SIMULATION_ALLOCATOR_T_HPP
@@ -33,8 +33,15 @@ namespace mechdancer {
     template<class t>
     concept Floating = std::is_floating_point_v<t>;
     
+    /// 定点数类型特征，定点数类型特化为 true
     template<class t>
-    concept Number = std::is_arithmetic_v<t>;
+    struct is_fixed_point : std::false_type {};
+    
+    template<class t>
+    concept FixedPoint = is_fixed_point<t>::value;
+    
+    template<class t>
+    concept Number = std::is_arithmetic_v<t> || FixedPoint<t>;
     
     template<class t>
     concept Frequency = requires(t f){ t::value; f.template cast_to<Hz_t>(); };
@@ -0,0 +1,181 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_FIXED_T_HPP
+#define DSP_SIMULATION_FIXED_T_HPP
+
+#include <cmath>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <compare>
+#include <type_traits>
+
+#include "signal_t.hpp"
+
+namespace mechdancer {
+    /// 有符号定点数，与单片机上 CMSIS-DSP 的 q7/q15/q31 格式及运算语义一致
+    /// - 加、减、取负饱和（__QADD16/__QSUB16/__QADD/__QSUB）
+    /// - 乘法取完整乘积右移小数位数后饱和，即向负无穷截断（arm_mult_q15）
+    /// - 由浮点数构造时四舍五入（远离 0）后饱和（arm_float_to_q15）
+    /// 由整数构造时按数值构造，q15 只能表示 [-1, 1)，整数 1 饱和为最大值
+    /// \tparam frac_bits 小数位数
+    /// \tparam storage_t 存储类型，8、16 或 32 位有符号整数
+    template<unsigned frac_bits, class storage_t = int16_t>
+    struct fixed_t {
+        static_assert(std::is_integral_v<storage_t> && std::is_signed_v<storage_t> && sizeof(storage_t) <= 4,
+                      "storage should be a signed integer of 8, 16 or 32 bits");
+        static_assert(frac_bits < 8 * sizeof(storage_t), "too many fraction bits");
+        
+        using storage_type = storage_t;
+        /// 乘积、中间结果使用的宽类型
+        using wide_t = std::conditional_t<sizeof(storage_t) <= 2, int32_t, int64_t>;
+        
+        constexpr static unsigned fraction = frac_bits;
+        constexpr static wide_t one = wide_t{1} << frac_bits;
+        constexpr static wide_t max_raw = std::numeric_limits<storage_t>::max();
+        constexpr static wide_t min_raw = std::numeric_limits<storage_t>::min();
+        
+        storage_t raw = 0;
+        
+        constexpr fixed_t() = default;
+        
+        template<Floating u>
+        constexpr fixed_t(u value) : raw(0) {
+            auto x = static_cast<double>(value) * static_cast<double>(one);
+            if (x != x) return;
+            x += x > 0 ? .5 : -.5;
+            raw = x >= static_cast<double>(max_raw) ? static_cast<storage_t>(max_raw)
+                : x <= static_cast<double>(min_raw) ? static_cast<storage_t>(min_raw)
+                : static_cast<storage_t>(static_cast<wide_t>(x));
+        }
+        
+        template<Integer u>
+        constexpr fixed_t(u value) : raw(0) {
+            if (std::cmp_greater(value, max_raw >> frac_bits)) raw = static_cast<storage_t>(max_raw);
+            else if (std::cmp_less(value, min_raw >> frac_bits)) raw = static_cast<storage_t>(min_raw);
+            else raw = static_cast<storage_t>(static_cast<wide_t>(value) * one);
+        }
+        
+        /// 饱和到存储类型的范围
+        constexpr static storage_t saturate(int64_t x) {
+            return static_cast<storage_t>(x > max_raw ? max_raw : x < min_raw ? min_raw : x);
+        }
+        
+        /// 由原始整数构造，超出范围时饱和
+        constexpr static fixed_t from_raw(int64_t x) {
+            fixed_t result;
+            result.raw = saturate(x);
+            return result;
+        }
+        
+        template<Floating u>
+        constexpr explicit operator u() const { return static_cast<u>(raw) / static_cast<u>(one); }
+        
+        constexpr fixed_t operator+() const { return *this; }
+        
+        constexpr fixed_t operator-() const { return from_raw(-static_cast<int64_t>(raw)); }
+        
+        friend constexpr fixed_t operator+(fixed_t a, fixed_t b) {
+            return from_raw(static_cast<wide_t>(a.raw) + b.raw);
+        }
+        
+        friend constexpr fixed_t operator-(fixed_t a, fixed_t b) {
+            return from_raw(static_cast<wide_t>(a.raw) - b.raw);
+        }
+        
+        friend constexpr fixed_t operator*(fixed_t a, fixed_t b) {
+            return from_raw((static_cast<wide_t>(a.raw) * b.raw) >> frac_bits);
+        }
+        
+        /// 除数为 0 时按被除数的符号饱和
+        friend constexpr fixed_t operator/(fixed_t a, fixed_t b) {
+            if (b.raw == 0) return from_raw(a.raw < 0 ? min_raw : max_raw);
+            return from_raw((static_cast<int64_t>(a.raw) << frac_bits) / b.raw);
+        }
+        
+        /// 乘整数，饱和（arm_scale 的整数倍情形）
+        template<Integer u>
+        friend constexpr fixed_t operator*(fixed_t a, u n) {
+            if (n == 0 || a.raw == 0) return {};
+            if (std::cmp_greater(n, max_raw - min_raw) || std::cmp_less(n, min_raw - max_raw))
+                return from_raw((a.raw < 0) == (n < 0) ? max_raw : min_raw);
+            return from_raw(static_cast<int64_t>(a.raw) * static_cast<int64_t>(n));
+        }
+        
+        template<Integer u>
+        friend constexpr fixed_t operator*(u n, fixed_t a) { return a * n; }
+        
+        /// 除以整数，向 0 截断，用于求均值
+        template<Integer u>
+        friend constexpr fixed_t operator/(fixed_t a, u n) {
+            if (n == 0) return from_raw(a.raw < 0 ? min_raw : max_raw);
+            if (std::cmp_greater(n, max_raw - min_raw)) return {};
+            return from_raw(static_cast<int64_t>(a.raw) / static_cast<int64_t>(n));
+        }
+        
+        constexpr fixed_t &operator+=(fixed_t others) { return *this = *this + others; }
+        
+        constexpr fixed_t &operator-=(fixed_t others) { return *this = *this - others; }
+        
+        constexpr fixed_t &operator*=(fixed_t others) { return *this = *this * others; }
+        
+        constexpr fixed_t &operator/=(fixed_t others) { return *this = *this / others; }
+        
+        constexpr bool operator==(fixed_t const &others) const = default;
+        
+        constexpr auto operator<=>(fixed_t const &others) const = default;
+    };
+    
+    template<unsigned frac_bits, class storage_t>
+    struct is_fixed_point<fixed_t<frac_bits, storage_t>> : std::true_type {};
+    
+    using q7_t = fixed_t<7, int8_t>;
+    using q15_t = fixed_t<15, int16_t>;
+    using q31_t = fixed_t<31, int32_t>;
+    
+    /// 绝对值，饱和（arm_abs_q15：-1 的绝对值为最大值）
+    template<unsigned frac_bits, class storage_t>
+    constexpr fixed_t<frac_bits, storage_t> abs(fixed_t<frac_bits, storage_t> x) {
+        return x.raw < 0 ? -x : x;
+    }
+    
+    /// 定点实信号
+    template<class t>
+    concept FixedSignal = RealSignal<t> && FixedPoint<typename t::value_t>;
+    
+    /// 浮点信号量化为定点信号
+    /// \tparam fixed 定点数类型
+    /// \tparam t 实信号类型
+    /// \param signal 信号
+    /// \return 定点信号，超出范围的采样饱和
+    template<FixedPoint fixed, RealSignal t>
+    auto quantize(t const &signal) {
+        return signal.template cast<fixed>(0, [](auto x) { return fixed(x); });
+    }
+    
+    /// 定点信号转为浮点信号
+    /// \tparam value_t 浮点类型
+    /// \tparam t 定点信号类型
+    /// \param signal 信号
+    /// \return 浮点信号
+    template<Floating value_t = float, FixedSignal t>
+    auto dequantize(t const &signal) {
+        return signal.template cast<value_t>(0, [](auto x) { return static_cast<value_t>(x); });
+    }
+    
+    /// 系数表量化为定点数，例如 quantize<q15_t>(lowpass_coefficients<...>)
+    /// \tparam fixed 定点数类型
+    /// \param values 系数表
+    /// \return 定点系数表
+    template<FixedPoint fixed, Floating t, size_t n>
+    constexpr std::array<fixed, n> quantize(std::array<t, n> const &values) {
+        std::array<fixed, n> result{};
+        for (size_t i = 0; i < n; ++i) result[i] = fixed(values[i]);
+        return result;
+    }
+}
+
+#endif // DSP_SIMULATION_FIXED_T_HPP
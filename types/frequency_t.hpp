@@ -11,9 +11,9 @@
 #include "concepts.h"
 
 namespace mechdancer {
-    /// Ƶ
-    /// \tparam _value_t ڲֶ
-    /// \tparam _ratio λںȵı
+    /// 频率类型
+    /// \tparam _value_t 内部字段类型
+    /// \tparam _ratio 单位相对于赫兹的比例
     template<class _value_t, class _ratio = std::ratio<1>>
     struct frequency_t {
         using value_t = _value_t;
@@ -22,8 +22,8 @@ namespace mechdancer {
         value_t value;
         
         template<class target_t>
-        target_t cast_to() const {
-            constexpr static double k = static_cast<double>(ratio::num * target_t::ratio::den) / (ratio::den * target_t::ratio::num);
+        constexpr target_t cast_to() const {
+            constexpr double k = static_cast<double>(ratio::num * target_t::ratio::den) / (ratio::den * target_t::ratio::num);
             return {static_cast<typename target_t::value_t>(value * k)};
         }
         
@@ -7,10 +7,13 @@
 
 #include <vector>
 #include <cmath>
-#include <numeric>
+#include <thread>
 #include <random>
+#include <algorithm>
 
 #include "signal_t.hpp"
+#include "philox_t.hpp"
+#include "reductions.h"
 
 namespace mechdancer {
     template<class t = float>
@@ -28,26 +31,16 @@ namespace mechdancer {
         auto operator<=>(db_t const &others) const = default;
     };
     
-    /// ֵķֱֵ
+    /// 构造信噪比值的分贝字面值
     constexpr db_t<> operator ""_db(long double db) {
         return {static_cast<float>(db)};
     }
     
-    /// ֵķֱֵ
+    /// 构造信噪比值的分贝字面值
     constexpr db_t<> operator ""_db(unsigned long long db) {
         return {static_cast<float>(db)};
     }
     
-    /// ʵź
-    /// \tparam sample_t ź
-    /// \param signal ź
-    /// \return ֵ
-    template<RealSignal t, class value_t = typename t::value_t>
-    value_t energy(t const &signal) {
-        return std::accumulate(signal.values.begin(), signal.values.end(), value_t{},
-                               [](value_t sum, value_t x) { return sum + x * x; });
-    }
-    
     template<RealSignal t, Number snr_t>
     auto sigma_noise(t const &signal, snr_t snr) {
         auto value = std::sqrt(energy(signal) / snr / signal.values.size());
@@ -59,43 +52,104 @@ namespace mechdancer {
         return sigma_noise(signal, snr.to_ratio());
     }
     
-    /// źżϸ˹
-    /// \tparam t ʵź
-    /// \tparam sigma_t ׼ֵ
-    /// \param signal ʵź
-    /// \param sigma ׼
+    /// 给信号加上可复现的高斯白噪声
+    /// 第 i 个采样上的噪声只由种子、流号和 i 决定，分块并行计算，结果与线程数无关
+    /// \tparam t 实信号类型
+    /// \tparam sigma_t 标准差值类型
+    /// \param signal 实信号
+    /// \param sigma 噪声标准差
+    /// \param seed 种子
+    /// \param stream 流号，同一种子的不同流互不相关
+    /// \param threads 线程数
+    template<class t, class sigma_t> requires RealSignal<t> && Number<sigma_t>
+    void add_noise(t &signal, sigma_t sigma, uint64_t seed, uint64_t stream = 0,
+                   size_t threads = std::thread::hardware_concurrency()) {
+        using value_t = typename t::value_t;
+        using noise_t = std::conditional_t<std::is_same_v<value_t, double>, double, float>;
+        constexpr static size_t BATCH = 1024;
+        constexpr static size_t MIN_CHUNK = size_t{1} << 16;
+        
+        if (sigma == 0) return;
+        const auto s = static_cast<noise_t>(sigma);
+        const auto sequence = normal_sequence_t<noise_t>{seed, stream};
+        auto &values = signal.values;
+        const auto size = values.size();
+        auto work = [&](size_t begin, size_t end) {
+            noise_t buffer[BATCH];
+            for (auto i = begin; i < end; i += BATCH) {
+                const auto n = std::min(BATCH, end - i);
+                sequence.fill(i, n, buffer);
+                for (size_t j = 0; j < n; ++j) values[i + j] += static_cast<value_t>(s * buffer[j]);
+            }
+        };
+        threads = std::clamp<size_t>(threads, 1, std::max<size_t>(size / MIN_CHUNK, 1));
+        std::vector<std::thread> tasks;
+        for (size_t i = 1; i < threads; ++i)
+            tasks.emplace_back(work, size * i / threads, size * (i + 1) / threads);
+        work(0, size / threads);
+        for (auto &task : tasks) task.join();
+    }
+    
+    /// 给信号加上高斯白噪声，种子取自 std::random_device，每次调用不同
+    /// \tparam t 实信号类型
+    /// \tparam sigma_t 标准差值类型
+    /// \param signal 实信号
+    /// \param sigma 噪声标准差
     template<class t, class sigma_t> requires RealSignal<t> && Number<sigma_t>
     void add_noise(t &signal, sigma_t sigma) {
-        if (sigma != 0) {
-            using value_t = typename t::value_t;
-            std::random_device rd{};
-            std::mt19937 gen{rd()};
-            std::normal_distribution<value_t> d{value_t{}, sigma};
-            for (auto &x : signal.values) x += d(gen);
-        }
+        std::random_device rd{};
+        add_noise(signal, sigma, static_cast<uint64_t>(rd()) << 32 | rd());
     }
     
-    /// źżϸ˹
-    /// \tparam snr_t ֵ
-    /// \tparam t ʵź
-    /// \tparam _value_t ź
-    /// \param signal ʵź
-    /// \param snr ֵ
+    /// 给信号加上高斯白噪声
+    /// \tparam snr_t 信噪比值类型
+    /// \tparam t 实信号类型
+    /// \tparam _value_t 信号数据类型
+    /// \param signal 实信号
+    /// \param snr 信噪比数值
     template<RealSignal t, Number snr_t>
     void add_noise_measured(t &signal, snr_t snr) {
         add_noise(signal, sigma_noise(signal, snr));
     }
     
-    /// źżϸ˹
-    /// \tparam snr_t ֵ
-    /// \tparam t ʵź
-    /// \tparam _value_t ź
-    /// \param signal ʵź
-    /// \param snr ֵ
+    /// 给信号加上高斯白噪声
+    /// \tparam snr_t 信噪比值类型
+    /// \tparam t 实信号类型
+    /// \tparam _value_t 信号数据类型
+    /// \param signal 实信号
+    /// \param snr 信噪比数值
     template<RealSignal t, Number snr_t>
     void add_noise_measured(t &signal, db_t<snr_t> snr) {
         add_noise_measured(signal, snr.to_ratio());
     }
+    
+    /// 按信噪比给信号加上可复现的高斯白噪声，见 add_noise
+    /// \tparam t 实信号类型
+    /// \tparam snr_t 信噪比值类型
+    /// \param signal 实信号
+    /// \param snr 信噪比数值
+    /// \param seed 种子
+    /// \param stream 流号
+    /// \param threads 线程数
+    template<RealSignal t, Number snr_t>
+    void add_noise_measured(t &signal, snr_t snr, uint64_t seed, uint64_t stream = 0,
+                            size_t threads = std::thread::hardware_concurrency()) {
+        add_noise(signal, sigma_noise(signal, snr), seed, stream, threads);
+    }
+    
+    /// 按信噪比给信号加上可复现的高斯白噪声，见 add_noise
+    /// \tparam t 实信号类型
+    /// \tparam snr_t 信噪比值类型
+    /// \param signal 实信号
+    /// \param snr 信噪比分贝值
+    /// \param seed 种子
+    /// \param stream 流号
+    /// \param threads 线程数
+    template<RealSignal t, Number snr_t>
+    void add_noise_measured(t &signal, db_t<snr_t> snr, uint64_t seed, uint64_t stream = 0,
+                            size_t threads = std::thread::hardware_concurrency()) {
+        add_noise_measured(signal, snr.to_ratio(), seed, stream, threads);
+    }
 }
 
 #endif // SIMULATION_NOISE_H
@@ -0,0 +1,344 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_PACKED12_T_HPP
+#define DSP_SIMULATION_PACKED12_T_HPP
+
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <iterator>
+#include <utility>
+#include <stdexcept>
+
+#include "signal_t.hpp"
+
+namespace mechdancer {
+    /// 12 位 ADC 采样的紧凑存储，每两个采样占 3 字节，比 16 位存储小 25%
+    /// 第 2k 个采样为第 3k 字节加第 3k + 1 字节的低 4 位（高位），
+    /// 第 2k + 1 个采样为第 3k + 1 字节的高 4 位加第 3k + 2 字节（高位）
+    class packed12_vector_t {
+        std::vector<uint8_t> _bytes;
+        size_t _size = 0;
+        
+        static size_t bytes_of(size_t size) { return (size + 1) / 2 * 3; }
+    
+    public:
+        using value_type = uint16_t;
+        
+        constexpr static uint16_t MASK = 0xfff;
+        
+        /// 只读随机访问迭代器，解引用得到采样值
+        class const_iterator {
+            packed12_vector_t const *_owner = nullptr;
+            std::ptrdiff_t _i = 0;
+        
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = uint16_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = uint16_t;
+            using pointer = void;
+            
+            const_iterator() = default;
+            
+            const_iterator(packed12_vector_t const *owner, std::ptrdiff_t i) : _owner(owner), _i(i) {}
+            
+            reference operator*() const { return (*_owner)[_i]; }
+            
+            reference operator[](difference_type n) const { return (*_owner)[_i + n]; }
+            
+            const_iterator &operator++() {
+                ++_i;
+                return *this;
+            }
+            
+            const_iterator operator++(int) { return {_owner, _i++}; }
+            
+            const_iterator &operator--() {
+                --_i;
+                return *this;
+            }
+            
+            const_iterator operator--(int) { return {_owner, _i--}; }
+            
+            const_iterator &operator+=(difference_type n) {
+                _i += n;
+                return *this;
+            }
+            
+            const_iterator &operator-=(difference_type n) {
+                _i -= n;
+                return *this;
+            }
+            
+            const_iterator operator+(difference_type n) const { return {_owner, _i + n}; }
+            
+            friend const_iterator operator+(difference_type n, const_iterator const &p) { return p + n; }
+            
+            const_iterator operator-(difference_type n) const { return {_owner, _i - n}; }
+            
+            difference_type operator-(const_iterator const &others) const { return _i - others._i; }
+            
+            bool operator==(const_iterator const &others) const { return _i == others._i; }
+            
+            auto operator<=>(const_iterator const &others) const { return _i <=> others._i; }
+        };
+        
+        using iterator = const_iterator;
+        
+        packed12_vector_t() = default;
+        
+        explicit packed12_vector_t(size_t size) : _bytes(bytes_of(size)), _size(size) {}
+        
+        /// 由 16 位采样构造，只保留低 12 位
+        template<class iterator_t>
+        packed12_vector_t(iterator_t begin, iterator_t end) {
+            reserve(static_cast<size_t>(std::distance(begin, end)));
+            for (; begin != end; ++begin) push_back(static_cast<uint16_t>(*begin));
+        }
+        
+        [[nodiscard]] size_t size() const { return _size; }
+        
+        [[nodiscard]] bool empty() const { return _size == 0; }
+        
+        /// 打包后的字节
+        [[nodiscard]] std::vector<uint8_t> const &bytes() const { return _bytes; }
+        
+        void reserve(size_t size) { _bytes.reserve(bytes_of(size)); }
+        
+        void resize(size_t size) {
+            _bytes.resize(bytes_of(size));
+            // 截短后未使用的半个字节清零，保持打包数据确定
+            if (size % 2) {
+                _bytes[size / 2 * 3 + 1] &= 0x0f;
+                _bytes[size / 2 * 3 + 2] = 0;
+            }
+            _size = size;
+        }
+        
+        void clear() { resize(0); }
+        
+        uint16_t operator[](size_t i) const {
+            auto const *p = _bytes.data() + i / 2 * 3;
+            return i % 2 ? static_cast<uint16_t>(p[1] >> 4 | p[2] << 4)
+                         : static_cast<uint16_t>(p[0] | (p[1] & 0x0f) << 8);
+        }
+        
+        /// 写入采样，只保留低 12 位
+        void set(size_t i, uint16_t value) {
+            auto *p = _bytes.data() + i / 2 * 3;
+            if (i % 2) {
+                p[1] = static_cast<uint8_t>((p[1] & 0x0f) | (value & 0x0f) << 4);
+                p[2] = static_cast<uint8_t>((value & MASK) >> 4);
+            } else {
+                p[0] = static_cast<uint8_t>(value);
+                p[1] = static_cast<uint8_t>((p[1] & 0xf0) | (value & MASK) >> 8);
+            }
+        }
+        
+        void push_back(uint16_t value) {
+            if (_size % 2 == 0) _bytes.resize(_bytes.size() + 3);
+            set(_size++, value);
+        }
+        
+        uint16_t front() const { return (*this)[0]; }
+        
+        uint16_t back() const { return (*this)[_size - 1]; }
+        
+        const_iterator begin() const { return {this, 0}; }
+        
+        const_iterator end() const { return {this, static_cast<std::ptrdiff_t>(_size)}; }
+        
+        /// 写出打包数据：采样数（64 位小端）后接打包的字节
+        void write(std::ostream &stream) const {
+            uint8_t header[8];
+            for (int i = 0; i < 8; ++i) header[i] = static_cast<uint8_t>(static_cast<uint64_t>(_size) >> 8 * i);
+            stream.write(reinterpret_cast<char const *>(header), sizeof header);
+            stream.write(reinterpret_cast<char const *>(_bytes.data()), static_cast<std::streamsize>(_bytes.size()));
+        }
+        
+        /// 读入 write 写出的打包数据
+        static packed12_vector_t read(std::istream &stream) {
+            uint8_t header[8];
+            if (!stream.read(reinterpret_cast<char *>(header), sizeof header))
+                throw std::runtime_error("failed to read packed samples");
+            uint64_t size = 0;
+            for (int i = 0; i < 8; ++i) size |= static_cast<uint64_t>(header[i]) << 8 * i;
+            auto result = packed12_vector_t(static_cast<size_t>(size));
+            if (!stream.read(reinterpret_cast<char *>(result._bytes.data()), static_cast<std::streamsize>(result._bytes.size())))
+                throw std::runtime_error("failed to read packed samples");
+            return result;
+        }
+    };
+    
+    /// 解包一段采样，out[i] = (x - offset) * scale
+    /// 按 3 字节 2 采样成组展开，循环体没有分支，可以向量化
+    /// \tparam t 输出类型
+    /// \param values 打包的采样
+    /// \param begin 起始序号
+    /// \param n 数量
+    /// \param out 输出
+    /// \param offset 零点
+    /// \param scale 比例
+    template<Number t>
+    void unpack(packed12_vector_t const &values, size_t begin, size_t n, t *out, t offset = t{}, t scale = t{1}) {
+        if (begin + n > values.size()) throw std::out_of_range("unpack range is out of range");
+        if (n == 0) return;
+        if (begin % 2) {
+            *out++ = (static_cast<t>(values[begin++]) - offset) * scale;
+            --n;
+        }
+        auto const *p = values.bytes().data() + begin / 2 * 3;
+        const auto pairs = n / 2;
+        for (size_t j = 0; j < pairs; ++j) {
+            auto b0 = p[3 * j], b1 = p[3 * j + 1], b2 = p[3 * j + 2];
+            out[2 * j] = (static_cast<t>(b0 | (b1 & 0x0f) << 8) - offset) * scale;
+            out[2 * j + 1] = (static_cast<t>(b1 >> 4 | b2 << 4) - offset) * scale;
+        }
+        if (n % 2) out[n - 1] = (static_cast<t>(values[begin + n - 1]) - offset) * scale;
+    }
+    
+    /// 解包一段采样作为实部直接写入 FFT 输入缓冲，虚部置 0
+    template<Number t>
+    void unpack(packed12_vector_t const &values, size_t begin, size_t n, complex_t<t> *out, t offset = t{}, t scale = t{1}) {
+        if (begin + n > values.size()) throw std::out_of_range("unpack range is out of range");
+        if (n == 0) return;
+        if (begin % 2) {
+            *out++ = {(static_cast<t>(values[begin++]) - offset) * scale, t{}};
+            --n;
+        }
+        auto const *p = values.bytes().data() + begin / 2 * 3;
+        const auto pairs = n / 2;
+        for (size_t j = 0; j < pairs; ++j) {
+            auto b0 = p[3 * j], b1 = p[3 * j + 1], b2 = p[3 * j + 2];
+            out[2 * j] = {(static_cast<t>(b0 | (b1 & 0x0f) << 8) - offset) * scale, t{}};
+            out[2 * j + 1] = {(static_cast<t>(b1 >> 4 | b2 << 4) - offset) * scale, t{}};
+        }
+        if (n % 2) out[n - 1] = {(static_cast<t>(values[begin + n - 1]) - offset) * scale, t{}};
+    }
+    
+    /// 紧凑存储的 12 位实信号
+    /// 满足实信号概念，可以只读地传给处理函数；求频谱时直接解包到 FFT 缓冲
+    /// \tparam _frequency_t 频率类型（frequency_t）
+    /// \tparam _time_t 时间类型（std::chrono::duration）
+    template<Frequency _frequency_t, Time _time_t>
+    struct packed12_signal_t {
+        using value_t = uint16_t;
+        using frequency_t = _frequency_t;
+        using time_t = _time_t;
+        using container_t = packed12_vector_t;
+        
+        container_t values;
+        _frequency_t sampling_frequency;
+        _time_t begin_time;
+        
+        /// 转换信号类型，见 signal_t::cast
+        template<class __value_t = value_t, Frequency __frequency_t = _frequency_t, Time __time_t = _time_t, class converter_t>
+        auto cast(long new_size, converter_t converter) const {
+            auto result = signal_t<__value_t, __frequency_t, __time_t>{
+                .values = std::vector<__value_t>(new_size > 0 ? new_size : values.size() + new_size, __value_t{}),
+                .sampling_frequency = sampling_frequency.template cast_to<__frequency_t>(),
+                .begin_time = std::chrono::duration_cast<__time_t>(begin_time),
+            };
+            const auto n = std::min(values.size(), result.values.size());
+            if constexpr (std::is_same_v<converter_t, nullptr_t> && Number<__value_t>)
+                unpack(values, 0, n, result.values.data());
+            else
+                std::transform(values.begin(), values.begin() + n, result.values.begin(), converter);
+            return result;
+        }
+    };
+    
+    template<class t>
+    struct is_packed12_signal : std::false_type {};
+    
+    template<class f, class _t>
+    struct is_packed12_signal<packed12_signal_t<f, _t>> : std::true_type {};
+    
+    /// 紧凑存储的 12 位实信号
+    template<class t>
+    concept PackedSignal = RealSignal<t> && is_packed12_signal<t>::value;
+    
+    /// 打包实信号
+    /// \tparam t 实信号类型
+    /// \param signal 采样值不超过 12 位的信号
+    /// \return 紧凑存储的信号
+    template<RealSignal t>
+    auto pack(t const &signal) {
+        return packed12_signal_t<typename t::frequency_t, typename t::time_t>{
+            .values = packed12_vector_t(signal.values.begin(), signal.values.end()),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+    }
+    
+    /// 带帧标记的 12 位采集数据
+    /// 采集文件中大于 4096 的值标记一帧的起点，其采样值为原值减 4096；
+    /// 这里把帧起点单独记录，采样紧凑存储
+    struct packed12_frames_t {
+        constexpr static uint16_t MARKER = 4096;
+        
+        packed12_vector_t samples;
+        std::vector<size_t> frames; // 各帧起点的序号
+        
+        /// 解析原始采集数据
+        /// \param begin 原始数据起点
+        /// \param end 原始数据终点
+        template<class iterator_t>
+        static packed12_frames_t parse(iterator_t begin, iterator_t end) {
+            packed12_frames_t result;
+            result.samples.reserve(static_cast<size_t>(std::distance(begin, end)));
+            for (; begin != end; ++begin) {
+                auto x = static_cast<uint16_t>(*begin);
+                if (x > MARKER) {
+                    result.frames.push_back(result.samples.size());
+                    x -= MARKER;
+                }
+                result.samples.push_back(x);
+            }
+            return result;
+        }
+        
+        /// 第 i 帧的范围
+        /// \return 起点序号和长度，长度到下一帧起点为止
+        [[nodiscard]] std::pair<size_t, size_t> frame(size_t i) const {
+            auto begin = frames.at(i);
+            auto end = i + 1 < frames.size() ? frames[i + 1] : samples.size();
+            return {begin, end - begin};
+        }
+        
+        /// 写出：帧数（64 位小端）、各帧起点、打包的采样
+        void write(std::ostream &stream) const {
+            auto put = [&](uint64_t x) {
+                uint8_t bytes[8];
+                for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(x >> 8 * i);
+                stream.write(reinterpret_cast<char const *>(bytes), sizeof bytes);
+            };
+            put(frames.size());
+            for (auto x : frames) put(x);
+            samples.write(stream);
+        }
+        
+        /// 读入 write 写出的数据
+        static packed12_frames_t read(std::istream &stream) {
+            auto get = [&] {
+                uint8_t bytes[8];
+                if (!stream.read(reinterpret_cast<char *>(bytes), sizeof bytes))
+                    throw std::runtime_error("failed to read packed frames");
+                uint64_t x = 0;
+                for (int i = 0; i < 8; ++i) x |= static_cast<uint64_t>(bytes[i]) << 8 * i;
+                return x;
+            };
+            packed12_frames_t result;
+            result.frames.resize(static_cast<size_t>(get()));
+            for (auto &x : result.frames) x = static_cast<size_t>(get());
+            result.samples = packed12_vector_t::read(stream);
+            return result;
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_PACKED12_T_HPP
@@ -0,0 +1,191 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_PHILOX_T_HPP
+#define DSP_SIMULATION_PHILOX_T_HPP
+
+#include <bit>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <numbers>
+#include <algorithm>
+
+#include "concepts.h"
+
+namespace mechdancer {
+    /// Philox4x32-10 计数器随机数发生器（Salmon 等，Random123）
+    /// 输出只由密钥和计数器决定，没有内部状态：任意位置的随机数可以直接算出，
+    /// 不同线程各算各的区间，结果与线程数、计算顺序无关
+    struct philox4x32_t {
+        using counter_t = std::array<uint32_t, 4>;
+        using key_t = std::array<uint32_t, 2>;
+        
+        constexpr static uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+        constexpr static uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+        
+        key_t key;
+        
+        constexpr counter_t operator()(counter_t c) const {
+            auto k = key;
+            for (auto round = 0; round < 10; ++round) {
+                const auto p0 = static_cast<uint64_t>(M0) * c[0];
+                const auto p1 = static_cast<uint64_t>(M1) * c[2];
+                c = {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<uint32_t>(p1),
+                     static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<uint32_t>(p0)};
+                k[0] += W0;
+                k[1] += W1;
+            }
+            return c;
+        }
+    };
+    
+    /// 可复现的标准正态分布随机数序列
+    /// 第 i 个数只由种子、流号和 i 决定：以 (i / 4, 流号) 为计数器、种子为密钥算出 4 个 32 位整数，
+    /// 两两经 Box-Muller 变换得到 4 个正态分布数，取第 i % 4 个。
+    /// 同一种子的不同流互不相关，可以分给不同的信号或不同的仿真次数。
+    /// 对数、平方根和正余弦用无分支的多项式、迭代计算（误差在 t 的舍入误差量级），变换循环可以向量化；
+    /// 均匀分布取 31 位，尾部截断在约 6.55σ
+    /// \tparam t 浮点类型
+    template<Floating t = float>
+    struct normal_sequence_t {
+        uint64_t seed = 0, stream = 0;
+    
+    private:
+        constexpr static size_t BATCH = 64;
+        using bits_t = std::conditional_t<sizeof(t) == 4, uint32_t, uint64_t>;
+        
+        /// ln(x)，x 为正规数
+        static t log(t x) {
+            constexpr static int MANTISSA = std::numeric_limits<t>::digits - 1;
+            constexpr static bits_t MASK = (bits_t{1} << MANTISSA) - 1;
+            constexpr static bits_t ONE = std::bit_cast<bits_t>(t{1});
+            constexpr static bits_t SQRT2 = std::bit_cast<bits_t>(std::numbers::sqrt2_v<t>);
+            constexpr static int TERMS = sizeof(t) == 4 ? 5 : 10;
+            const auto bits = std::bit_cast<bits_t>(x);
+            // 尾数归约到 [√(1/2), √2)，只用整数运算，没有分支
+            auto mantissa = (bits & MASK) | ONE;
+            const auto big = static_cast<bits_t>(mantissa > SQRT2);
+            mantissa -= big << MANTISSA;
+            const auto m = std::bit_cast<t>(mantissa);
+            const auto e = static_cast<t>(static_cast<int>(bits >> MANTISSA) - static_cast<int>(ONE >> MANTISSA) + static_cast<int>(big));
+            // ln(m) = 2 artanh(f) = 2 (f + f^3/3 + f^5/5 + ...)，|f| < 0.172
+            const auto f = (m - 1) / (m + 1);
+            const auto f2 = f * f;
+            auto p = t{1} / (2 * TERMS - 1);
+            for (auto k = TERMS - 2; k >= 0; --k) p = p * f2 + t{1} / (2 * k + 1);
+            return e * std::numbers::ln2_v<t> + 2 * f * p;
+        }
+        
+        /// √x，x ≥ 0，由平方根倒数的牛顿迭代求得
+        static t sqrt(t x) {
+            constexpr static bits_t MAGIC = sizeof(t) == 4 ? bits_t(0x5f375a86) : bits_t(0x5fe6eb50c7b537a9);
+            constexpr static int ITERATIONS = sizeof(t) == 4 ? 3 : 4;
+            const auto y = x + std::numeric_limits<t>::min();
+            auto r = std::bit_cast<t>(MAGIC - (std::bit_cast<bits_t>(y) >> 1));
+            for (auto i = 0; i < ITERATIONS; ++i) r = r * (t{1.5} - t{.5} * y * r * r);
+            return x * r;
+        }
+        
+        /// cos(2πu)、sin(2πu)，u ∈ [0, 1)
+        static void cos_sin(t u, t &c, t &s) {
+            constexpr static int TERMS = sizeof(t) == 4 ? 5 : 9;
+            // 按象限归约到 [-π/4, π/4)
+            const auto v = u * 4 + t{.5};
+            const auto q = static_cast<int>(v);
+            const auto x = (v - static_cast<t>(q) - t{.5}) * (std::numbers::pi_v<t> / 2);
+            const auto x2 = x * x;
+            auto ps = t{1}, pc = t{1};
+            for (auto k = TERMS - 1; k >= 1; --k) {
+                ps = 1 - x2 / static_cast<t>((2 * k) * (2 * k + 1)) * ps;
+                pc = 1 - x2 / static_cast<t>((2 * k - 1) * (2 * k)) * pc;
+            }
+            const auto sx = x * ps, cx = pc;
+            // 角度为 qπ/2 + x：奇象限交换正余弦，第 1、2 象限余弦取负，第 2、3 象限正弦取负
+            // 以乘加代替选择，在没有掩码指令的指令集上也可以向量化
+            const auto swap = static_cast<t>(q & 1);
+            const auto sign_c = static_cast<t>(1 - ((q + 1) & 2));
+            const auto sign_s = static_cast<t>(1 - (q & 2));
+            c = (swap * sx + (1 - swap) * cx) * sign_c;
+            s = (swap * cx + (1 - swap) * sx) * sign_s;
+        }
+        
+        /// 取高 31 位转为浮点数，有符号整数的转换在各指令集上都可以向量化
+        static t uniform(uint32_t x) { return static_cast<t>(static_cast<int32_t>(x >> 1)); }
+        
+        /// 连续 count 个计数器对应的 4 count 个数
+        /// Philox 按轮次对一批计数器逐轮计算，每轮都是独立元素上的整数乘、异或，可以向量化
+        void blocks(uint64_t first, size_t count, t *out) const {
+            constexpr static t SCALE = t{1} / t{2147483648.0};
+            uint32_t c0[BATCH], c1[BATCH], c2[BATCH], c3[BATCH];
+            for (size_t b = 0; b < count; b += BATCH) {
+                const auto n = std::min(BATCH, count - b);
+                for (size_t i = 0; i < n; ++i) {
+                    c0[i] = static_cast<uint32_t>(first + b + i);
+                    c1[i] = static_cast<uint32_t>((first + b + i) >> 32);
+                    c2[i] = static_cast<uint32_t>(stream);
+                    c3[i] = static_cast<uint32_t>(stream >> 32);
+                }
+                auto k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+                for (auto round = 0; round < 10; ++round) {
+                    for (size_t i = 0; i < n; ++i) {
+                        const auto p0 = static_cast<uint64_t>(philox4x32_t::M0) * c0[i];
+                        const auto p1 = static_cast<uint64_t>(philox4x32_t::M1) * c2[i];
+                        c0[i] = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+                        c1[i] = static_cast<uint32_t>(p1);
+                        c2[i] = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+                        c3[i] = static_cast<uint32_t>(p0);
+                    }
+                    k0 += philox4x32_t::W0;
+                    k1 += philox4x32_t::W1;
+                }
+                auto *p = out + 4 * b;
+                for (size_t i = 0; i < n; ++i) {
+                    // u1 ∈ (0, 1]，避免 log(0)
+                    const auto r0 = sqrt(-2 * log((uniform(c0[i]) + 1) * SCALE));
+                    const auto r1 = sqrt(-2 * log((uniform(c2[i]) + 1) * SCALE));
+                    t cos0, sin0, cos1, sin1;
+                    cos_sin(uniform(c1[i]) * SCALE, cos0, sin0);
+                    cos_sin(uniform(c3[i]) * SCALE, cos1, sin1);
+                    p[4 * i] = r0 * cos0;
+                    p[4 * i + 1] = r0 * sin0;
+                    p[4 * i + 2] = r1 * cos1;
+                    p[4 * i + 3] = r1 * sin1;
+                }
+            }
+        }
+    
+    public:
+        /// 第 index 个数
+        t operator[](uint64_t index) const {
+            t buffer[4];
+            blocks(index / 4, 1, buffer);
+            return buffer[index % 4];
+        }
+        
+        /// 生成从第 begin 个开始的 n 个数
+        /// \param begin 起始序号
+        /// \param n 数量
+        /// \param out 输出
+        void fill(uint64_t begin, size_t n, t *out) const {
+            t buffer[4];
+            if (begin % 4 && n) {
+                blocks(begin / 4, 1, buffer);
+                const auto m = std::min<size_t>(4 - begin % 4, n);
+                std::copy_n(buffer + begin % 4, m, out);
+                begin += m;
+                out += m;
+                n -= m;
+            }
+            blocks(begin / 4, n / 4, out);
+            if (n % 4) {
+                blocks(begin / 4 + n / 4, 1, buffer);
+                std::copy_n(buffer, n % 4, out + n / 4 * 4);
+            }
+        }
+    };
+}
+
+#endif // DSP_SIMULATION_PHILOX_T_HPP
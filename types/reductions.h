@@ -0,0 +1,335 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_REDUCTIONS_H
+#define DSP_SIMULATION_REDUCTIONS_H
+
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "signal_t.hpp"
+
+namespace mechdancer {
+    /// 求和的累加类型：浮点数、定点数用自身，整数用 double
+    template<class t>
+    using sum_t = std::conditional_t<std::is_integral_v<t>, double, t>;
+    
+    /// 比较大小用的键：实数为自身，复数为模的平方
+    template<class t>
+    auto magnitude_key(t const &x) {
+        if constexpr (requires { x.re; x.im; })
+            return x.re * x.re + x.im * x.im;
+        else
+            return x;
+    }
+    
+    /// 按下标访问数据的起点：连续存储时为首元素指针，循环可以向量化；
+    /// 否则（跨步视图、12 位压缩数据等）为随机访问迭代器，逐个经 operator[] 取值
+    template<class container_t>
+    auto data_of(container_t const &values) {
+        if constexpr (std::ranges::contiguous_range<container_t const>)
+            return std::data(values);
+        else
+            return std::begin(values);
+    }
+    
+    /// 映射后求和
+    /// 块内 8 路独立累加，循环可以向量化；块间两两递归相加，舍入误差随 log n 而非 n 增长
+    /// \tparam acc_t 累加类型
+    /// \param data 数据，指针或随机访问迭代器
+    /// \param n 数量
+    /// \param map 映射
+    /// \return 和
+    template<class acc_t, class data_t, class map_t>
+    acc_t pairwise_sum(data_t data, size_t n, map_t map) {
+        constexpr static size_t LANES = 8, BLOCK = 1024;
+        if (n > BLOCK) {
+            const auto half = std::max(BLOCK, n / 2 / BLOCK * BLOCK);
+            return pairwise_sum<acc_t>(data, half, map) + pairwise_sum<acc_t>(data + half, n - half, map);
+        }
+        acc_t lanes[LANES]{};
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES)
+            for (size_t j = 0; j < LANES; ++j) lanes[j] += map(data[i + j]);
+        for (size_t j = 0; i < n; ++i, ++j) lanes[j] += map(data[i]);
+        for (auto width = LANES / 2; width; width /= 2)
+            for (size_t j = 0; j < width; ++j) lanes[j] += lanes[j + width];
+        return lanes[0];
+    }
+    
+    /// 把 [0, n) 分成固定长度的段，由若干线程处理
+    /// 段的划分与线程数无关，按段计算的结果也就与线程数无关
+    /// \param n 总长度
+    /// \param chunk 段长
+    /// \param threads 线程数
+    /// \param fun 处理函数，参数为段序号、段的起止位置
+    template<class fun_t>
+    void for_each_chunk(size_t n, size_t chunk, size_t threads, fun_t fun) {
+        const auto count = (n + chunk - 1) / chunk;
+        auto work = [&](size_t from, size_t to) {
+            for (auto k = from; k < to; ++k) fun(k, k * chunk, std::min(n, (k + 1) * chunk));
+        };
+        threads = std::clamp<size_t>(threads, 1, std::max<size_t>(count, 1));
+        std::vector<std::thread> tasks;
+        for (size_t i = 1; i < threads; ++i)
+            tasks.emplace_back(work, count * i / threads, count * (i + 1) / threads);
+        work(0, count / threads);
+        for (auto &task : tasks) task.join();
+    }
+    
+    /// 映射后求和，长数据分段并行
+    /// 超过一段的数据总是先分段求和再两两相加，结果与线程数无关
+    template<class acc_t, class data_t, class map_t>
+    acc_t parallel_sum(data_t data, size_t n, map_t map, size_t threads) {
+        constexpr static size_t CHUNK = size_t{1} << 16;
+        if (n <= CHUNK) return pairwise_sum<acc_t>(data, n, map);
+        std::vector<acc_t> partial((n + CHUNK - 1) / CHUNK);
+        for_each_chunk(n, CHUNK, threads, [&](size_t k, size_t begin, size_t end) {
+            partial[k] = pairwise_sum<acc_t>(data + begin, end - begin, map);
+        });
+        return pairwise_sum<acc_t>(partial.data(), partial.size(), [](acc_t x) { return x; });
+    }
+    
+    /// 最大（greater 为真）或最小的键及其位置，相等时取最前一个
+    /// 按块求各路的极值（比较、选择可以向量化），只在极值所在的块内逐个查找位置
+    /// \return 位置、键；n 为 0 时位置为 0，键无意义
+    template<bool greater, class data_t, class map_t>
+    auto extremum(data_t data, size_t n, map_t map) {
+        constexpr static size_t LANES = 8, BLOCK = 1024;
+        using key_t = decltype(map(*data));
+        auto better = [](key_t a, key_t b) { return greater ? a > b : a < b; };
+        if (n == 0) return std::pair<size_t, key_t>{0, key_t{}};
+        auto best = map(data[0]);
+        size_t block = 0;
+        for (size_t b = 0; b < n; b += BLOCK) {
+            const auto m = std::min(BLOCK, n - b);
+            auto p = data + b;
+            key_t lanes[LANES];
+            std::fill_n(lanes, LANES, map(p[0]));
+            size_t i = 0;
+            for (; i + LANES <= m; i += LANES)
+                for (size_t j = 0; j < LANES; ++j) {
+                    const auto x = map(p[i + j]);
+                    lanes[j] = better(x, lanes[j]) ? x : lanes[j];
+                }
+            for (; i < m; ++i) {
+                const auto x = map(p[i]);
+                lanes[0] = better(x, lanes[0]) ? x : lanes[0];
+            }
+            for (size_t j = 1; j < LANES; ++j)
+                if (better(lanes[j], lanes[0])) lanes[0] = lanes[j];
+            if (better(lanes[0], best)) {
+                best = lanes[0];
+                block = b;
+            }
+        }
+        auto i = block;
+        while (better(best, map(data[i]))) ++i;
+        return std::pair<size_t, key_t>{i, best};
+    }
+    
+    /// 最大或最小的键的位置，长数据分段并行，相等时取最前一个
+    template<bool greater, class data_t, class map_t>
+    size_t parallel_extremum(data_t data, size_t n, map_t map, size_t threads) {
+        constexpr static size_t CHUNK = size_t{1} << 16;
+        if (n <= CHUNK) return extremum<greater>(data, n, map).first;
+        std::vector<decltype(extremum<greater>(data, n, map))> partial((n + CHUNK - 1) / CHUNK);
+        for_each_chunk(n, CHUNK, threads, [&](size_t k, size_t begin, size_t end) {
+            partial[k] = extremum<greater>(data + begin, end - begin, map);
+            partial[k].first += begin;
+        });
+        auto result = partial.front();
+        for (auto const &part : partial)
+            if (greater ? part.second > result.second : part.second < result.second) result = part;
+        return result.first;
+    }
+    
+    /// 将 [begin, end) 限制在数据范围内
+    inline std::pair<size_t, size_t> clamp_range(size_t size, size_t begin, size_t end) {
+        end = std::min(end, size);
+        return {std::min(begin, end), end};
+    }
+    
+    /// 求和
+    /// \param values 可随机访问的数值
+    /// \param threads 线程数
+    /// \return 和，整数的和为 double，复数按实部、虚部分别求和
+    template<class container_t>
+    auto sum(container_t const &values, size_t threads = 1) {
+        const auto data = data_of(values);
+        using value_t = std::remove_cvref_t<decltype(*data)>;
+        const auto n = std::size(values);
+        if constexpr (requires(value_t z) { z.re; z.im; }) {
+            using acc_t = sum_t<decltype(value_t{}.re)>;
+            return complex_t<acc_t>{
+                parallel_sum<acc_t>(data, n, [](value_t z) { return static_cast<acc_t>(z.re); }, threads),
+                parallel_sum<acc_t>(data, n, [](value_t z) { return static_cast<acc_t>(z.im); }, threads),
+            };
+        } else {
+            using acc_t = sum_t<value_t>;
+            return parallel_sum<acc_t>(data, n, [](value_t x) { return static_cast<acc_t>(x); }, threads);
+        }
+    }
+    
+    /// 求信号均值
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param threads 线程数
+    /// \return 均值
+    template<Signal t, class value_t = typename t::value_t>
+    value_t mean(t const &signal, size_t threads = 1) {
+        if (signal.values.empty()) return value_t{};
+        return static_cast<value_t>(sum(signal.values, threads) / signal.values.size());
+    }
+    
+    /// 计算实信号能量
+    /// \tparam t 实信号类型
+    /// \param signal 信号
+    /// \param threads 线程数
+    /// \return 能量值
+    template<RealSignal t, class value_t = typename t::value_t>
+    value_t energy(t const &signal, size_t threads) {
+        using acc_t = sum_t<value_t>;
+        using x_t = typename t::value_t;
+        return static_cast<value_t>(parallel_sum<acc_t>(
+            data_of(signal.values), signal.values.size(),
+            [](x_t x) {
+                const auto y = static_cast<acc_t>(x);
+                return y * y;
+            }, threads));
+    }
+    
+    /// 计算实信号能量
+    /// \tparam t 实信号类型
+    /// \param signal 信号
+    /// \return 能量值
+    template<RealSignal t, class value_t = typename t::value_t>
+    value_t energy(t const &signal) {
+        return energy<t, value_t>(signal, 1);
+    }
+    
+    /// 计算复信号能量（模的平方和）
+    /// \tparam t 复信号类型
+    /// \param signal 信号
+    /// \param threads 线程数
+    /// \return 能量值
+    template<ComplexSignal t, class value_t = typename t::value_t::value_t>
+    value_t energy(t const &signal, size_t threads = 1) {
+        using acc_t = sum_t<value_t>;
+        using x_t = typename t::value_t;
+        return static_cast<value_t>(parallel_sum<acc_t>(
+            data_of(signal.values), signal.values.size(),
+            [](x_t z) {
+                const auto re = static_cast<acc_t>(z.re), im = static_cast<acc_t>(z.im);
+                return re * re + im * im;
+            }, threads));
+    }
+    
+    /// 求信号均方根值
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param threads 线程数
+    /// \return 均方根值
+    template<Signal t>
+    auto rms(t const &signal, size_t threads = 1) {
+        using value_t = decltype(energy(signal, threads));
+        if (signal.values.empty()) return value_t{};
+        return static_cast<value_t>(std::sqrt(energy(signal, threads) / signal.values.size()));
+    }
+    
+    /// 信号最大值的位置，复信号比较模，相等时取最前一个
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param begin 搜索起点
+    /// \param end 搜索终点（不含）
+    /// \param threads 线程数
+    /// \return 位置；范围为空时返回 end
+    template<Signal t>
+    size_t argmax(t const &signal, size_t begin = 0, size_t end = std::numeric_limits<size_t>::max(), size_t threads = 1) {
+        using x_t = typename t::value_t;
+        std::tie(begin, end) = clamp_range(signal.values.size(), begin, end);
+        if (begin == end) return end;
+        return begin + parallel_extremum<true>(data_of(signal.values) + begin, end - begin,
+                                               [](x_t x) { return magnitude_key(x); }, threads);
+    }
+    
+    /// 信号最小值的位置，复信号比较模，相等时取最前一个
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param begin 搜索起点
+    /// \param end 搜索终点（不含）
+    /// \param threads 线程数
+    /// \return 位置；范围为空时返回 end
+    template<Signal t>
+    size_t argmin(t const &signal, size_t begin = 0, size_t end = std::numeric_limits<size_t>::max(), size_t threads = 1) {
+        using x_t = typename t::value_t;
+        std::tie(begin, end) = clamp_range(signal.values.size(), begin, end);
+        if (begin == end) return end;
+        return begin + parallel_extremum<false>(data_of(signal.values) + begin, end - begin,
+                                                [](x_t x) { return magnitude_key(x); }, threads);
+    }
+    
+    /// 首个不小于阈值的采样的位置，复信号比较模
+    /// 每 64 个采样统计一次越过阈值的个数（比较、累加可以向量化），有越过时才逐个查找
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param threshold 阈值
+    /// \param begin 搜索起点
+    /// \param end 搜索终点（不含）
+    /// \return 位置；没有越过阈值的采样时返回 end
+    template<Signal t, class threshold_t>
+    size_t first_crossing(t const &signal, threshold_t threshold,
+                          size_t begin = 0, size_t end = std::numeric_limits<size_t>::max()) {
+        constexpr static size_t BLOCK = 64;
+        using x_t = typename t::value_t;
+        std::tie(begin, end) = clamp_range(signal.values.size(), begin, end);
+        const auto data = data_of(signal.values);
+        using key_t = decltype(magnitude_key(x_t{}));
+        const auto limit = std::is_same_v<key_t, x_t>
+                           ? static_cast<key_t>(threshold)
+                           : static_cast<key_t>(threshold) * static_cast<key_t>(threshold);
+        for (auto b = begin; b < end; b += BLOCK) {
+            const auto m = std::min(BLOCK, end - b);
+            size_t count = 0;
+            for (size_t i = 0; i < m; ++i) count += magnitude_key(data[b + i]) >= limit;
+            if (count)
+                for (size_t i = 0;; ++i)
+                    if (magnitude_key(data[b + i]) >= limit) return b + i;
+        }
+        return end;
+    }
+    
+    /// 从起点向后的首个局部极大值的位置，即首个后一个采样不大于它的采样，复信号比较模
+    /// 每 64 个采样统计一次下降的个数（比较、累加可以向量化），有下降时才逐个查找
+    /// \tparam t 实信号或复信号类型
+    /// \param signal 信号
+    /// \param begin 搜索起点
+    /// \param end 搜索终点（不含）
+    /// \return 位置；直到终点都在上升时返回 end - 1，范围为空时返回 end
+    template<Signal t>
+    size_t local_maximum(t const &signal, size_t begin = 0, size_t end = std::numeric_limits<size_t>::max()) {
+        constexpr static size_t BLOCK = 64;
+        std::tie(begin, end) = clamp_range(signal.values.size(), begin, end);
+        if (begin == end) return end;
+        const auto data = data_of(signal.values);
+        for (auto b = begin; b + 1 < end; b += BLOCK) {
+            const auto m = std::min(BLOCK, end - 1 - b);
+            size_t count = 0;
+            for (size_t i = 0; i < m; ++i) count += magnitude_key(data[b + i + 1]) <= magnitude_key(data[b + i]);
+            if (count)
+                for (size_t i = 0;; ++i)
+                    if (magnitude_key(data[b + i + 1]) <= magnitude_key(data[b + i])) return b + i;
+        }
+        return end - 1;
+    }
+}
+
+#endif // DSP_SIMULATION_REDUCTIONS_H
@@ -7,10 +7,12 @@
 
 #include <chrono>
 #include <vector>
+#include <utility>
 #include <algorithm>
 
 #include "concepts.h"
 #include "complex_t.hpp"
+#include "allocator_t.hpp"
 
 namespace mechdancer {
     template<class t>
@@ -29,32 +31,36 @@ namespace mechdancer {
     template<class t>
     concept ComplexSignal = Signal<t> && std::same_as<typename t::value_t, complex_t<typename t::value_t::value_t>>;
     
-    /// ź
-    /// \tparam _value_t 
-    /// \tparam _frequency_t Ƶͣfrequency_t
-    /// \tparam _time_t ʱͣstd::chrono::duration
-    template<class _value_t, Frequency _frequency_t, Time _time_t>
+    /// 信号类型
+    /// \tparam _value_t 数据类型
+    /// \tparam _frequency_t 频率类型（frequency_t）
+    /// \tparam _time_t 时间类型（std::chrono::duration）
+    /// \tparam _allocator_t 数据的分配器类型
+    template<class _value_t, Frequency _frequency_t, Time _time_t, class _allocator_t = std::allocator<_value_t>>
     struct signal_t {
         using value_t = _value_t;
         using frequency_t = _frequency_t;
         using time_t = _time_t;
+        using allocator_t = _allocator_t;
+        using container_t = std::vector<value_t, _allocator_t>;
         
-        std::vector<value_t> values;
+        container_t values;
         _frequency_t sampling_frequency;
         _time_t begin_time;
         
-        /// תź
-        /// \tparam __value_t µֵ
-        /// \tparam __frequency_t µƵ
-        /// \tparam __time_t µʱ
-        /// \tparam converter_t ת
-        /// \param new_size µɢźų
-        /// \param converter ת
-        /// \return Ŀ͵ź
+        /// 转换信号类型，新信号沿用此信号的分配器
+        /// \tparam __value_t 新的值类型
+        /// \tparam __frequency_t 新的频率类型
+        /// \tparam __time_t 新的时间类型
+        /// \tparam converter_t 转换器类型
+        /// \param new_size 新的离散信号长度
+        /// \param converter 转换器
+        /// \return 目标类型的信号
         template<class __value_t = _value_t, Frequency __frequency_t = _frequency_t, Time __time_t = _time_t, class converter_t>
-        auto cast(long new_size, converter_t converter) const {
-            auto result = signal_t<__value_t, __frequency_t, __time_t>{
-                .values = std::vector<__value_t>(new_size > 0 ? new_size : values.size() + new_size, __value_t{}),
+        auto cast(long new_size, converter_t converter) const &{
+            using new_allocator_t = typename std::allocator_traits<_allocator_t>::template rebind_alloc<__value_t>;
+            auto result = signal_t<__value_t, __frequency_t, __time_t, new_allocator_t>{
+                .values = std::vector<__value_t, new_allocator_t>(new_size > 0 ? new_size : values.size() + new_size, __value_t{}),
                 .sampling_frequency = sampling_frequency.template cast_to<__frequency_t>(),
                 .begin_time = std::chrono::duration_cast<__time_t>(begin_time),
             };
@@ -64,53 +70,165 @@ namespace mechdancer {
                 std::transform(values.begin(), values.begin() + std::min(values.size(), result.values.size()), result.values.begin(), converter);
             return result;
         }
+        
+        /// 转换即将销毁的信号
+        /// 值类型不变时原位转换并移交存储，不再分配；值类型改变时转换后立即释放原信号的存储
+        template<class __value_t = _value_t, Frequency __frequency_t = _frequency_t, Time __time_t = _time_t, class converter_t>
+        auto cast(long new_size, converter_t converter) &&{
+            if constexpr (std::is_same_v<__value_t, _value_t>) {
+                const auto n = new_size > 0 ? static_cast<size_t>(new_size) : values.size() + new_size;
+                if constexpr (!std::is_same_v<converter_t, nullptr_t>)
+                    std::transform(values.begin(), values.begin() + std::min(values.size(), n), values.begin(), converter);
+                values.resize(n, __value_t{});
+                return signal_t<__value_t, __frequency_t, __time_t, _allocator_t>{
+                    .values = std::move(values),
+                    .sampling_frequency = sampling_frequency.template cast_to<__frequency_t>(),
+                    .begin_time = std::chrono::duration_cast<__time_t>(begin_time),
+                };
+            } else {
+                auto result = std::as_const(*this).template cast<__value_t, __frequency_t, __time_t>(new_size, converter);
+                container_t().swap(values);
+                return result;
+            }
+        }
+        
+        /// 对信号表达式求值并赋给此信号，表达式中可以出现此信号自身
+        /// \tparam expression_t 表达式类型
+        /// \param e 表达式
+        /// \return 此信号
+        template<class expression_t> requires requires(expression_t const &e) { e.is_expression; e.at(0); }
+        signal_t &operator=(expression_t const &e) {
+            const auto n = e.size();
+            auto result = container_t(n);
+            auto *p = result.data();
+            for (size_t i = 0; i < n; ++i) p[i] = static_cast<value_t>(e.at(i));
+            values = std::move(result);
+            sampling_frequency = e.sampling_frequency.template cast_to<_frequency_t>();
+            begin_time = std::chrono::duration_cast<_time_t>(e.begin_time);
+            return *this;
+        }
+    };
+    
+    /// 信号的分配器类型，重绑定到 value_t；没有分配器的信号（如视图）使用 std::allocator
+    template<class t, class value_t = typename t::value_t>
+    struct allocator_of {
+        using type = std::allocator<value_t>;
     };
     
-    /// յʵź
-    /// \tparam _value_t 
-    /// \tparam frequency_t Ƶ
-    /// \tparam time_t ʱ
-    /// \param size źų
-    /// \param frequency Ƶ
-    /// \param time ʼʱ
-    /// \return ʵźŶ
-    template<class _value_t = float, Frequency frequency_t, Time time_t>
+    template<class t, class value_t> requires requires { typename t::allocator_t; }
+    struct allocator_of<t, value_t> {
+        using type = typename std::allocator_traits<typename t::allocator_t>::template rebind_alloc<value_t>;
+    };
+    
+    template<class t, class value_t = typename t::value_t>
+    using allocator_of_t = typename allocator_of<t, value_t>::type;
+    
+    /// 数据按缓存行对齐的信号类型
+    template<class value_t, Frequency frequency_t, Time time_t>
+    using aligned_signal_t = signal_t<value_t, frequency_t, time_t, aligned_allocator_t<value_t>>;
+    
+    /// 数据从线程局部内存池分配的信号类型，反复执行的流程中不再向系统申请内存
+    template<class value_t, Frequency frequency_t, Time time_t>
+    using pooled_signal_t = signal_t<value_t, frequency_t, time_t, pool_allocator_t<value_t>>;
+    
+    /// 构造空的实信号
+    /// \tparam _value_t 数据类型
+    /// \tparam frequency_t 频率类型
+    /// \tparam time_t 时间类型
+    /// \tparam allocator_t 分配器类型
+    /// \param size 信号长度
+    /// \param frequency 采样频率
+    /// \param time 起始时间
+    /// \return 实信号对象
+    template<class _value_t = float, class allocator_t = std::allocator<_value_t>, Frequency frequency_t, Time time_t>
     auto signal_of(size_t size, frequency_t frequency, time_t time) {
-        return signal_t<_value_t, frequency_t, time_t>{
-            .values = std::vector<_value_t>(size),
+        return signal_t<_value_t, frequency_t, time_t, allocator_t>{
+            .values = std::vector<_value_t, allocator_t>(size),
             .sampling_frequency = frequency,
             .begin_time = time,
         };
     }
     
-    /// ʵźΪʵɸź
-    /// \tparam t ź
-    /// \param signal ʵź
-    /// \return ź
+    /// 实信号作为实部生成复信号
+    /// \tparam t 信号类型
+    /// \param signal 实信号
+    /// \return 复信号
     template<RealSignal t, Number value_t = typename t::value_t>
     auto complex(t const &signal) {
         return signal.template cast<complex_t<value_t>>(0, [](auto x) -> complex_t<value_t> { return x; });
     }
     
-    /// źȡʵķʽתΪʵź
-    /// \tparam _value_t ֵ
-    /// \tparam t ź
-    /// \param signal ź
-    /// \return źʵɵʵź
+    /// 实信号作为实部生成复信号，转换后立即释放原信号的存储
+    template<RealSignal t, Number value_t = typename t::value_t>
+    auto complex(t &&signal) {
+        return std::move(signal).template cast<complex_t<value_t>>(0, [](auto x) -> complex_t<value_t> { return x; });
+    }
+    
+    /// 复信号以取实部的方式转换为实信号
+    /// \tparam _value_t 复数值类型
+    /// \tparam t 信号类型
+    /// \param signal 复信号
+    /// \return 复信号实部组成的实信号
     template<ComplexSignal t, class value_t = typename t::value_t::value_t>
     auto real(t const &signal) {
         return signal.template cast<value_t>(0, [](auto z) -> value_t { return z.re; });
     }
     
-    /// źȡģķʽתΪʵź
-    /// \tparam _value_t ֵ
-    /// \tparam t ź
-    /// \param signal ź
-    /// \return źģɵʵź
+    /// 复信号以取实部的方式转换为实信号，转换后立即释放原信号的存储
+    template<ComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto real(t &&signal) {
+        return std::move(signal).template cast<value_t>(0, [](auto z) -> value_t { return z.re; });
+    }
+    
+    /// 复信号以取模的方式转换为实信号
+    /// \tparam _value_t 复数值类型
+    /// \tparam t 信号类型
+    /// \param signal 复信号
+    /// \return 复信号模组成的实信号
     template<ComplexSignal t, class value_t = typename t::value_t::value_t>
     auto abs(t const &signal) {
         return signal.template cast<value_t>(0, [](auto z) -> value_t { return z.norm(); });
     }
+    
+    /// 复信号以取模的方式转换为实信号，转换后立即释放原信号的存储
+    template<ComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto abs(t &&signal) {
+        return std::move(signal).template cast<value_t>(0, [](auto z) -> value_t { return z.norm(); });
+    }
+    
+    /// 逐点转换信号并写入已有的信号，复用目标信号的存储
+    /// 在循环中反复转换时，目标信号容量足够后不再分配
+    /// \param signal 原信号
+    /// \param out 目标信号
+    /// \param converter 转换器
+    template<Signal t, Signal u, class converter_t>
+    void convert_into(t const &signal, u &out, converter_t converter) {
+        out.values.resize(signal.values.size());
+        std::transform(signal.values.begin(), signal.values.end(), out.values.begin(), converter);
+        out.sampling_frequency = signal.sampling_frequency.template cast_to<typename u::frequency_t>();
+        out.begin_time = std::chrono::duration_cast<typename u::time_t>(signal.begin_time);
+    }
+    
+    /// 实信号作为实部写入已有的复信号
+    template<RealSignal t, ComplexSignal u>
+    void complex(t const &signal, u &out) {
+        using value_t = typename u::value_t;
+        convert_into(signal, out, [](auto x) -> value_t { return x; });
+    }
+    
+    /// 复信号的实部写入已有的实信号
+    template<ComplexSignal t, RealSignal u>
+    void real(t const &signal, u &out) {
+        using value_t = typename u::value_t;
+        convert_into(signal, out, [](auto const &z) -> value_t { return static_cast<typename t::value_t>(z).re; });
+    }
+    
+    /// 复信号的模写入已有的实信号
+    template<ComplexSignal t, RealSignal u>
+    void abs(t const &signal, u &out) {
+        using value_t = typename u::value_t;
+        convert_into(signal, out, [](auto const &z) -> value_t { return static_cast<typename t::value_t>(z).norm(); });
+    }
 }
 
 #endif // DSP_SIMULATION_SIGNAL_T_HPP
@@ -0,0 +1,270 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SIGNAL_VIEW_T_HPP
+#define DSP_SIMULATION_SIGNAL_VIEW_T_HPP
+
+#include <span>
+#include <iterator>
+#include <stdexcept>
+
+#include "signal_t.hpp"
+
+namespace mechdancer {
+    /// 带步长的连续内存视图
+    /// \tparam t 元素类型，可以带 const
+    template<class t>
+    class strided_span_t {
+        t *_data = nullptr;
+        size_t _size = 0, _stride = 1;
+    
+    public:
+        using element_type = t;
+        using value_type = std::remove_cv_t<t>;
+        
+        class iterator {
+            t *_p = nullptr;
+            std::ptrdiff_t _stride = 1;
+        
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_cv_t<t>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = t *;
+            using reference = t &;
+            
+            iterator() = default;
+            
+            iterator(t *p, std::ptrdiff_t stride) : _p(p), _stride(stride) {}
+            
+            reference operator*() const { return *_p; }
+            
+            pointer operator->() const { return _p; }
+            
+            reference operator[](difference_type n) const { return _p[n * _stride]; }
+            
+            iterator &operator++() {
+                _p += _stride;
+                return *this;
+            }
+            
+            iterator operator++(int) {
+                auto result = *this;
+                _p += _stride;
+                return result;
+            }
+            
+            iterator &operator--() {
+                _p -= _stride;
+                return *this;
+            }
+            
+            iterator operator--(int) {
+                auto result = *this;
+                _p -= _stride;
+                return result;
+            }
+            
+            iterator &operator+=(difference_type n) {
+                _p += n * _stride;
+                return *this;
+            }
+            
+            iterator &operator-=(difference_type n) {
+                _p -= n * _stride;
+                return *this;
+            }
+            
+            iterator operator+(difference_type n) const { return {_p + n * _stride, _stride}; }
+            
+            friend iterator operator+(difference_type n, iterator const &p) { return p + n; }
+            
+            iterator operator-(difference_type n) const { return {_p - n * _stride, _stride}; }
+            
+            difference_type operator-(iterator const &others) const { return (_p - others._p) / _stride; }
+            
+            bool operator==(iterator const &others) const { return _p == others._p; }
+            
+            auto operator<=>(iterator const &others) const { return _p <=> others._p; }
+        };
+        
+        strided_span_t() = default;
+        
+        /// 构造视图
+        /// \param data 首元素地址
+        /// \param size 元素数
+        /// \param stride 相邻元素的间隔
+        strided_span_t(t *data, size_t size, size_t stride) : _data(data), _size(size), _stride(stride) {}
+        
+        [[nodiscard]] size_t size() const { return _size; }
+        
+        [[nodiscard]] size_t stride() const { return _stride; }
+        
+        [[nodiscard]] bool empty() const { return _size == 0; }
+        
+        t &operator[](size_t i) const { return _data[i * _stride]; }
+        
+        t &front() const { return _data[0]; }
+        
+        t &back() const { return _data[(_size - 1) * _stride]; }
+        
+        iterator begin() const { return {_data, static_cast<std::ptrdiff_t>(_stride)}; }
+        
+        // 尾后迭代器只参与比较和求差，不解引用
+        iterator end() const { return begin() + static_cast<std::ptrdiff_t>(_size); }
+        
+        /// 子视图
+        /// \param offset 起始序号
+        /// \param count 元素数
+        strided_span_t subspan(size_t offset, size_t count) const { return {_data + offset * _stride, count, _stride}; }
+        
+        /// 再抽取
+        /// \param step 步长
+        strided_span_t every(size_t step) const { return {_data, (_size + step - 1) / step, _stride * step}; }
+    };
+    
+    /// 不持有数据的信号视图
+    /// 与 signal_t 有相同的成员，满足信号概念，可以直接传给各种处理函数；
+    /// 切片和抽取都是 O(1) 的，不复制数据。视图的有效期不能超过其引用的信号
+    /// \tparam _element_t 元素类型，只读视图为 const 类型
+    /// \tparam _frequency_t 频率类型（frequency_t）
+    /// \tparam _time_t 时间类型（std::chrono::duration）
+    /// \tparam _values_t 数据视图类型，std::span 或 strided_span_t
+    template<class _element_t, Frequency _frequency_t, Time _time_t, class _values_t = std::span<_element_t>>
+    struct signal_view_t {
+        using value_t = std::remove_cv_t<_element_t>;
+        using frequency_t = _frequency_t;
+        using time_t = _time_t;
+        using owning_t = signal_t<value_t, _frequency_t, _time_t>;
+        
+        _values_t values;
+        _frequency_t sampling_frequency;
+        _time_t begin_time;
+        
+        /// 切片
+        /// \param offset 起始序号
+        /// \param count 长度，超出时截断
+        /// \return 子视图，起始时间相应后移
+        signal_view_t slice(size_t offset, size_t count = -1) const {
+            if (offset > values.size()) throw std::out_of_range("slice offset is out of range");
+            return {
+                .values = values.subspan(offset, std::min(count, values.size() - offset)),
+                .sampling_frequency = sampling_frequency,
+                .begin_time = begin_time + sampling_frequency.template duration_of<_time_t>(offset),
+            };
+        }
+        
+        /// 按步长抽取，不做抗混叠滤波
+        /// \param step 步长
+        /// \return 采样频率为原来 1/step 的视图
+        auto every(size_t step) const {
+            if (step == 0) throw std::invalid_argument("step should be positive");
+            auto strided = [this] {
+                if constexpr (std::is_same_v<_values_t, strided_span_t<_element_t>>)
+                    return values;
+                else
+                    return strided_span_t<_element_t>(values.data(), values.size(), 1);
+            }();
+            return signal_view_t<_element_t, _frequency_t, _time_t, strided_span_t<_element_t>>{
+                .values = strided.every(step),
+                .sampling_frequency = sampling_frequency / step,
+                .begin_time = begin_time,
+            };
+        }
+        
+        /// 复制出持有数据的信号
+        owning_t to_signal() const {
+            return {
+                .values = std::vector<value_t>(values.begin(), values.end()),
+                .sampling_frequency = sampling_frequency,
+                .begin_time = begin_time,
+            };
+        }
+        
+        /// 转换信号类型，见 signal_t::cast
+        template<class __value_t = value_t, Frequency __frequency_t = _frequency_t, Time __time_t = _time_t, class converter_t>
+        auto cast(long new_size, converter_t converter) const {
+            auto result = signal_t<__value_t, __frequency_t, __time_t>{
+                .values = std::vector<__value_t>(new_size > 0 ? new_size : values.size() + new_size, __value_t{}),
+                .sampling_frequency = sampling_frequency.template cast_to<__frequency_t>(),
+                .begin_time = std::chrono::duration_cast<__time_t>(begin_time),
+            };
+            if constexpr (std::is_same_v<converter_t, nullptr_t>)
+                std::copy_n(values.begin(), std::min(values.size(), result.values.size()), result.values.begin());
+            else
+                std::transform(values.begin(), values.begin() + std::min(values.size(), result.values.size()), result.values.begin(), converter);
+            return result;
+        }
+    };
+    
+    template<class t>
+    struct is_signal_view : std::false_type {};
+    
+    template<class e, class f, class _t, class v>
+    struct is_signal_view<signal_view_t<e, f, _t, v>> : std::true_type {};
+    
+    /// 信号视图
+    template<class t>
+    concept SignalView = is_signal_view<std::remove_cvref_t<t>>::value;
+    
+    /// 信号或视图对应的持有数据的信号类型，沿用信号的分配器
+    template<Signal t>
+    using owning_signal_t = signal_t<typename t::value_t, typename t::frequency_t, typename t::time_t, allocator_of_t<t>>;
+    
+    /// 取得整个信号的视图
+    /// \param signal 信号
+    /// \return 视图，通过它可以修改原信号
+    template<class value_t, Frequency frequency_t, Time time_t, class allocator_t>
+    auto view_of(signal_t<value_t, frequency_t, time_t, allocator_t> &signal) {
+        return signal_view_t<value_t, frequency_t, time_t>{
+            .values = std::span<value_t>(signal.values),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+    }
+    
+    /// 取得整个信号的只读视图
+    /// \param signal 信号
+    /// \return 只读视图
+    template<class value_t, Frequency frequency_t, Time time_t, class allocator_t>
+    auto view_of(signal_t<value_t, frequency_t, time_t, allocator_t> const &signal) {
+        return signal_view_t<value_t const, frequency_t, time_t>{
+            .values = std::span<value_t const>(signal.values),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+    }
+    
+    /// 以一段连续内存构造视图
+    /// \param values 数据
+    /// \param frequency 采样频率
+    /// \param time 起始时间
+    /// \return 视图
+    template<class value_t, Frequency frequency_t, Time time_t>
+    auto view_of(std::span<value_t> values, frequency_t frequency, time_t time) {
+        return signal_view_t<value_t, frequency_t, time_t>{
+            .values = values,
+            .sampling_frequency = frequency,
+            .begin_time = time,
+        };
+    }
+    
+    /// 切片，不复制数据
+    /// \param signal 信号或视图，不能是临时对象
+    /// \param offset 起始序号
+    /// \param count 长度，超出时截断
+    /// \return 视图
+    template<Signal t>
+    auto slice(t &signal, size_t offset, size_t count = -1) {
+        if constexpr (SignalView<t>)
+            return signal.slice(offset, count);
+        else
+            return view_of(signal).slice(offset, count);
+    }
+    
+    template<Signal t>
+    void slice(t &&signal, size_t offset, size_t count = -1) = delete;
+}
+
+#endif // DSP_SIMULATION_SIGNAL_VIEW_T_HPP
@@ -0,0 +1,316 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef DSP_SIMULATION_SPLIT_SIGNAL_T_HPP
+#define DSP_SIMULATION_SPLIT_SIGNAL_T_HPP
+
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include "signal_t.hpp"
+
+namespace mechdancer {
+    /// 实部、虚部分开存储的复数数组
+    /// 逐点运算时实部、虚部各自连续，不需要在寄存器中解交织
+    /// \tparam t 实数类型
+    /// \tparam allocator_t 分配器类型
+    template<Number t, class allocator_t = std::allocator<t>>
+    struct split_complex_vector_t {
+        using value_type = complex_t<t>;
+        
+        std::vector<t, allocator_t> re, im;
+        
+        /// 元素的代理引用，读出为复数，可以用复数赋值
+        class reference {
+            t *_re, *_im;
+        
+        public:
+            reference(t *re, t *im) : _re(re), _im(im) {}
+            
+            reference(reference const &) = default;
+            
+            operator complex_t<t>() const { return {*_re, *_im}; }
+            
+            reference &operator=(complex_t<t> const &z) {
+                *_re = z.re;
+                *_im = z.im;
+                return *this;
+            }
+            
+            reference &operator=(reference const &others) { return *this = static_cast<complex_t<t>>(others); }
+        };
+        
+        /// 随机访问迭代器
+        /// \tparam is_const 是否只读
+        template<bool is_const>
+        class iterator_t {
+            using pointer_t = std::conditional_t<is_const, t const *, t *>;
+            
+            pointer_t _re = nullptr, _im = nullptr;
+        
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = complex_t<t>;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<is_const, complex_t<t>, typename split_complex_vector_t::reference>;
+            using pointer = void;
+            
+            iterator_t() = default;
+            
+            iterator_t(pointer_t re, pointer_t im) : _re(re), _im(im) {}
+            
+            reference operator*() const {
+                if constexpr (is_const) return {*_re, *_im};
+                else return {_re, _im};
+            }
+            
+            reference operator[](difference_type n) const { return *(*this + n); }
+            
+            iterator_t &operator++() {
+                ++_re, ++_im;
+                return *this;
+            }
+            
+            iterator_t operator++(int) {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+            
+            iterator_t &operator--() {
+                --_re, --_im;
+                return *this;
+            }
+            
+            iterator_t operator--(int) {
+                auto result = *this;
+                --*this;
+                return result;
+            }
+            
+            iterator_t &operator+=(difference_type n) {
+                _re += n, _im += n;
+                return *this;
+            }
+            
+            iterator_t &operator-=(difference_type n) {
+                _re -= n, _im -= n;
+                return *this;
+            }
+            
+            iterator_t operator+(difference_type n) const { return {_re + n, _im + n}; }
+            
+            friend iterator_t operator+(difference_type n, iterator_t const &p) { return p + n; }
+            
+            iterator_t operator-(difference_type n) const { return {_re - n, _im - n}; }
+            
+            difference_type operator-(iterator_t const &others) const { return _re - others._re; }
+            
+            bool operator==(iterator_t const &others) const { return _re == others._re; }
+            
+            auto operator<=>(iterator_t const &others) const { return _re <=> others._re; }
+        };
+        
+        using iterator = iterator_t<false>;
+        using const_iterator = iterator_t<true>;
+        
+        split_complex_vector_t() = default;
+        
+        explicit split_complex_vector_t(size_t size) : re(size), im(size) {}
+        
+        template<class iterator_t>
+        split_complex_vector_t(iterator_t begin, iterator_t end) {
+            const auto n = static_cast<size_t>(std::distance(begin, end));
+            re.resize(n);
+            im.resize(n);
+            for (size_t i = 0; begin != end; ++begin, ++i) {
+                complex_t<t> z = *begin;
+                re[i] = z.re;
+                im[i] = z.im;
+            }
+        }
+        
+        [[nodiscard]] size_t size() const { return re.size(); }
+        
+        [[nodiscard]] bool empty() const { return re.empty(); }
+        
+        void resize(size_t size, complex_t<t> const &value = {}) {
+            re.resize(size, value.re);
+            im.resize(size, value.im);
+        }
+        
+        reference operator[](size_t i) { return {re.data() + i, im.data() + i}; }
+        
+        complex_t<t> operator[](size_t i) const { return {re[i], im[i]}; }
+        
+        reference front() { return (*this)[0]; }
+        
+        complex_t<t> front() const { return (*this)[0]; }
+        
+        reference back() { return (*this)[size() - 1]; }
+        
+        complex_t<t> back() const { return (*this)[size() - 1]; }
+        
+        iterator begin() { return {re.data(), im.data()}; }
+        
+        iterator end() { return begin() + static_cast<std::ptrdiff_t>(size()); }
+        
+        const_iterator begin() const { return {re.data(), im.data()}; }
+        
+        const_iterator end() const { return begin() + static_cast<std::ptrdiff_t>(size()); }
+    };
+    
+    /// 实部、虚部分开存储的复信号
+    /// 满足复信号概念，可以传给接受复信号的函数，也有专门的逐点频谱运算
+    /// \tparam t 实数类型
+    /// \tparam _frequency_t 频率类型（frequency_t）
+    /// \tparam _time_t 时间类型（std::chrono::duration）
+    /// \tparam _allocator_t 实部、虚部数组的分配器类型
+    template<Number t, Frequency _frequency_t, Time _time_t, class _allocator_t = std::allocator<t>>
+    struct split_signal_t {
+        using value_t = complex_t<t>;
+        using frequency_t = _frequency_t;
+        using time_t = _time_t;
+        using allocator_t = _allocator_t;
+        using container_t = split_complex_vector_t<t, _allocator_t>;
+        
+        container_t values;
+        _frequency_t sampling_frequency;
+        _time_t begin_time;
+    };
+    
+    template<class t>
+    struct is_split_signal : std::false_type {};
+    
+    template<class t, class f, class _t, class a>
+    struct is_split_signal<split_signal_t<t, f, _t, a>> : std::true_type {};
+    
+    /// 实部、虚部分开存储的复信号
+    template<class t>
+    concept SplitComplexSignal = ComplexSignal<t> && is_split_signal<t>::value;
+    
+    /// 交织存储的复信号转为分开存储
+    /// \tparam t 复信号类型
+    /// \param signal 复信号
+    /// \return 分开存储的复信号
+    template<ComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto split(t const &signal) {
+        using allocator_t = allocator_of_t<t, value_t>;
+        auto result = split_signal_t<value_t, typename t::frequency_t, typename t::time_t, allocator_t>{
+            .values = split_complex_vector_t<value_t, allocator_t>(signal.values.size()),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        auto *re = result.values.re.data();
+        auto *im = result.values.im.data();
+        for (size_t i = 0; i < signal.values.size(); ++i) {
+            complex_t<value_t> z = signal.values[i];
+            re[i] = z.re;
+            im[i] = z.im;
+        }
+        return result;
+    }
+    
+    /// 分开存储的复信号转为交织存储
+    /// \tparam t 分开存储的复信号类型
+    /// \param signal 复信号
+    /// \return 交织存储的复信号
+    template<SplitComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto interleave(t const &signal) {
+        using allocator_t = allocator_of_t<t, complex_t<value_t>>;
+        auto result = signal_t<complex_t<value_t>, typename t::frequency_t, typename t::time_t, allocator_t>{
+            .values = std::vector<complex_t<value_t>, allocator_t>(signal.values.size()),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        auto const *re = signal.values.re.data();
+        auto const *im = signal.values.im.data();
+        for (size_t i = 0; i < result.values.size(); ++i) result.values[i] = {re[i], im[i]};
+        return result;
+    }
+    
+    /// 分开存储的复信号取实部，直接复制实部数组
+    template<SplitComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto real(t const &signal) {
+        return signal_t<value_t, typename t::frequency_t, typename t::time_t, typename t::allocator_t>{
+            .values = signal.values.re,
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+    }
+    
+    /// 分开存储的复信号取模，实部、虚部连续访存，可以向量化
+    template<SplitComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto abs(t const &signal) {
+        const auto n = signal.values.size();
+        auto result = signal_t<value_t, typename t::frequency_t, typename t::time_t, typename t::allocator_t>{
+            .values = std::vector<value_t, typename t::allocator_t>(n),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        auto const *re = signal.values.re.data();
+        auto const *im = signal.values.im.data();
+        auto *p = result.values.data();
+        for (size_t i = 0; i < n; ++i) p[i] = std::sqrt(re[i] * re[i] + im[i] * im[i]);
+        return result;
+    }
+    
+    /// 即将销毁的分开存储的复信号取实部，直接移交实部数组
+    template<SplitComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto real(t &&signal) {
+        auto result = signal_t<value_t, typename t::frequency_t, typename t::time_t, typename t::allocator_t>{
+            .values = std::move(signal.values.re),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        decltype(signal.values.im)().swap(signal.values.im);
+        return result;
+    }
+    
+    /// 即将销毁的分开存储的复信号取模，模写入实部数组并移交，不再分配
+    template<SplitComplexSignal t, class value_t = typename t::value_t::value_t>
+    auto abs(t &&signal) {
+        auto *re = signal.values.re.data();
+        auto const *im = signal.values.im.data();
+        for (size_t i = 0; i < signal.values.size(); ++i) re[i] = std::sqrt(re[i] * re[i] + im[i] * im[i]);
+        return real(std::move(signal));
+    }
+    
+    /// 实信号作为实部转为分开存储的复信号
+    /// \tparam t 实信号类型
+    /// \param signal 实信号
+    /// \return 分开存储的复信号，虚部为 0
+    template<RealSignal t, class value_t = typename t::value_t>
+    auto split(t const &signal) {
+        using allocator_t = allocator_of_t<t, value_t>;
+        auto result = split_signal_t<value_t, typename t::frequency_t, typename t::time_t, allocator_t>{
+            .values = split_complex_vector_t<value_t, allocator_t>(signal.values.size()),
+            .sampling_frequency = signal.sampling_frequency,
+            .begin_time = signal.begin_time,
+        };
+        std::copy(signal.values.begin(), signal.values.end(), result.values.re.begin());
+        return result;
+    }
+    
+    /// 即将销毁的实信号作为实部转为分开存储的复信号，原信号的存储直接成为实部数组
+    template<RealSignal t, class value_t = typename t::value_t>
+    auto split(t &&signal) {
+        if constexpr (requires { requires std::is_same_v<typename t::container_t, std::vector<value_t, allocator_of_t<t, value_t>>>; }) {
+            using allocator_t = allocator_of_t<t, value_t>;
+            auto result = split_signal_t<value_t, typename t::frequency_t, typename t::time_t, allocator_t>{
+                .sampling_frequency = signal.sampling_frequency,
+                .begin_time = signal.begin_time,
+            };
+            result.values.im.resize(signal.values.size());
+            result.values.re = std::move(signal.values);
+            return result;
+        } else
+            return split(std::as_const(signal));
+    }
+}
+
+#endif // DSP_SIMULATION_SPLIT_SIGNAL_T_HPP